@@ -0,0 +1,90 @@
+#include "arena.h"
+
+#define ARENA_ALIGNMENT 16
+
+// ----- ARENA -----
+static ArenaChunk* arena_new_chunk(size_t capacity) {
+    ArenaChunk* chunk = malloc(sizeof(ArenaChunk) + capacity);
+    if (!chunk) { return NULL; }
+
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+
+    return chunk;
+}
+
+Arena* arena_init(size_t chunk_size) {
+    Arena* new_arena = malloc(sizeof(Arena));
+    if (!new_arena) { return NULL; }
+
+    new_arena->chunk_size = chunk_size;
+    new_arena->head = arena_new_chunk(chunk_size);
+    new_arena->current = new_arena->head;
+
+    if (!new_arena->head) {
+        free(new_arena);
+        return NULL;
+    }
+
+    return new_arena;
+}
+
+// Returns NULL once malloc cannot provide another chunk.
+void* arena_alloc(Arena* arena, size_t size) {
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    // Move on to the next chunk that fits, reusing chunks kept by a reset
+    // before growing the chain.
+    while (arena->current->used + size > arena->current->capacity) {
+        if (!arena->current->next) {
+            size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+            arena->current->next = arena_new_chunk(capacity);
+            if (!arena->current->next) { return NULL; }
+        }
+        arena->current = arena->current->next;
+    }
+
+    void* memory = arena->current->data + arena->current->used;
+    arena->current->used += size;
+
+    return memory;
+}
+
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    void* memory = arena_alloc(arena, count * size);
+    if (memory) { memset(memory, 0, count * size); }
+
+    return memory;
+}
+
+char* arena_strndup(Arena* arena, const char* src, size_t length) {
+    char* copy = arena_alloc(arena, length + 1);
+    if (!copy) { return NULL; }
+
+    memcpy(copy, src, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
+void arena_reset(Arena* arena) {
+    for (ArenaChunk* chunk = arena->head; chunk; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+
+    arena->current = arena->head;
+}
+
+void free_arena(Arena* arena) {
+    if (!arena) { return; }
+
+    ArenaChunk* chunk = arena->head;
+    while (chunk) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    free(arena);
+}
@@ -0,0 +1,30 @@
+#ifndef Q_ARENA_H
+#define Q_ARENA_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ----- ARENA -----
+// Bump allocator for short lived scratch memory. Nothing is freed on its own,
+// a reset hands every chunk back for reuse without returning it to malloc.
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t capacity;
+    size_t used;
+    unsigned char data[];
+} ArenaChunk;
+
+typedef struct {
+    ArenaChunk* head;
+    ArenaChunk* current;
+    size_t chunk_size;
+} Arena;
+
+Arena* arena_init(size_t chunk_size);
+void* arena_alloc(Arena* arena, size_t size);
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+char* arena_strndup(Arena* arena, const char* src, size_t length);
+void arena_reset(Arena* arena);
+void free_arena(Arena* arena);
+
+#endif
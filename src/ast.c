@@ -1,16 +1,15 @@
 #include "ast.h"
 
-ASTNode* ast_init() {
-    ASTNode* new_ast = malloc(sizeof(ASTNode));
-    if (!new_ast) {
-        printf("Failed to allocate memory for new ast root\n");
-        exit(EXIT_FAILURE);
-    }
+ASTNode* ast_init(Arena* arena) {
+    ASTNode* new_ast = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_ast) { return NULL; }
 
     new_ast->type = AST_PROGRAM;
-    new_ast->value.program.functions = ast_create_empty();
+    new_ast->value.program.functions = ast_create_empty(arena);
     new_ast->next = NULL;
 
+    if (!new_ast->value.program.functions) { return NULL; }
+
     return new_ast;
 }
 
@@ -31,12 +30,9 @@ void ast_append_node(ASTNode** branch_root, ASTNode* node_to_append) {
     last_node->next = node_to_append;
 }
 
-ASTNode* ast_create_empty() {
-    ASTNode* new_ast = calloc(1, sizeof(ASTNode));
-    if (!new_ast) {
-        printf("Failed to allocate memory for new ast empty node\n");
-        exit(EXIT_FAILURE);
-    }
+ASTNode* ast_create_empty(Arena* arena) {
+    ASTNode* new_ast = arena_calloc(arena, 1, sizeof(ASTNode));
+    if (!new_ast) { return NULL; }
 
     new_ast->type = AST_NONE;
 
@@ -44,16 +40,16 @@ ASTNode* ast_create_empty() {
 
 }
 
-ASTNode* ast_create_fn_decl(const char* name, const char* return_type, ASTNode* body) {
-    if (!body) {
-        printf("Body AST node passed into fn decl is not valid\n");
-        exit(EXIT_FAILURE);
-    }
+ASTNode* ast_create_fn_decl(Arena* arena, const char* name, ASTNode* params, int param_count, const char* return_type, ASTNode* body) {
+    if (!body) { return NULL; }
 
-    ASTNode* new_fn_decl_node = malloc(sizeof(ASTNode));
-    new_fn_decl_node->type = AST_FUNCTION_DECL;
+    ASTNode* new_fn_decl_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_fn_decl_node) { return NULL; }
 
+    new_fn_decl_node->type = AST_FUNCTION_DECL;
     new_fn_decl_node->value.function_decl.name = name;
+    new_fn_decl_node->value.function_decl.params = params;
+    new_fn_decl_node->value.function_decl.param_count = param_count;
     new_fn_decl_node->value.function_decl.return_type = return_type;
     new_fn_decl_node->value.function_decl.body = body;
     new_fn_decl_node->next = NULL;
@@ -61,17 +57,36 @@ ASTNode* ast_create_fn_decl(const char* name, const char* return_type, ASTNode*
     return new_fn_decl_node;
 }
 
-ASTNode* ast_create_var_decl(const char* name, const char* type, ASTNode* value) {
-    if (value->type != AST_LITERAL) {
-        printf("Var decl value must be a literal\n");
-        exit(EXIT_FAILURE);
-    }
+ASTNode* ast_create_fn_call(Arena* arena, const char* name, ASTNode* args, int arg_count) {
+    ASTNode* new_fn_call_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_fn_call_node) { return NULL; }
 
-    ASTNode* new_var_decl_node = malloc(sizeof(ASTNode));
-    if (!new_var_decl_node) {
-        printf("Failed to allocate memory for var decl node\n");
-        exit(EXIT_FAILURE);
-    }
+    new_fn_call_node->type = AST_FUNCTION_CALL;
+    new_fn_call_node->value.function_call.name = name;
+    new_fn_call_node->value.function_call.args = args;
+    new_fn_call_node->value.function_call.arg_count = arg_count;
+    new_fn_call_node->next = NULL;
+
+    return new_fn_call_node;
+}
+
+ASTNode* ast_create_param(Arena* arena, const char* name, const char* type) {
+    ASTNode* new_param_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_param_node) { return NULL; }
+
+    new_param_node->type = AST_PARAMETER;
+    new_param_node->value.parameter.name = name;
+    new_param_node->value.parameter.type = type;
+    new_param_node->next = NULL;
+
+    return new_param_node;
+}
+
+ASTNode* ast_create_var_decl(Arena* arena, const char* name, const char* type, ASTNode* value) {
+    if (!ast_is_expr(value)) { return NULL; }
+
+    ASTNode* new_var_decl_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_var_decl_node) { return NULL; }
 
     new_var_decl_node->type = AST_VARIABLE_DECL;
     new_var_decl_node->value.variable_decl.name = name;
@@ -82,12 +97,9 @@ ASTNode* ast_create_var_decl(const char* name, const char* type, ASTNode* value)
     return new_var_decl_node;
 }
 
-ASTNode* ast_create_literal(const char* type, int value) {
-    ASTNode* new_literal_node = malloc(sizeof(ASTNode));
-    if (!new_literal_node) {
-        printf("Failed to allocate memory for new literal node\n");
-        exit(EXIT_FAILURE);
-    }
+ASTNode* ast_create_literal(Arena* arena, const char* type, int value) {
+    ASTNode* new_literal_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_literal_node) { return NULL; }
 
     new_literal_node->type = AST_LITERAL;
     new_literal_node->value.literal.int_value = value;
@@ -97,17 +109,11 @@ ASTNode* ast_create_literal(const char* type, int value) {
     return new_literal_node;
 }
 
-ASTNode* ast_create_return_stmt(ASTNode* value) {
-    if (!value || value->type != AST_LITERAL) {
-        printf("Value given in ret stmt node creation is not valid\n");
-        exit(EXIT_FAILURE);
-    }
+ASTNode* ast_create_return_stmt(Arena* arena, ASTNode* value) {
+    if (!ast_is_expr(value)) { return NULL; }
 
-    ASTNode* new_ret_stmt_node = malloc(sizeof(ASTNode));
-    if (!new_ret_stmt_node) {
-        printf("Failed to allocate memory for new return stmt node\n");
-        exit(EXIT_FAILURE);
-    }
+    ASTNode* new_ret_stmt_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_ret_stmt_node) { return NULL; }
 
     new_ret_stmt_node->type = AST_RETURN_STMT;
     new_ret_stmt_node->value.return_stmt.value = value;
@@ -116,69 +122,142 @@ ASTNode* ast_create_return_stmt(ASTNode* value) {
     return new_ret_stmt_node;
 }
 
-void print_ast(ASTNode* root) {
+ASTNode* ast_create_identifier(Arena* arena, const char* name) {
+    ASTNode* new_identifier_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_identifier_node) { return NULL; }
+
+    new_identifier_node->type = AST_IDENTIFIER;
+    new_identifier_node->value.identifier.name = name;
+    new_identifier_node->next = NULL;
+
+    return new_identifier_node;
+}
+
+ASTNode* ast_create_binary_op(Arena* arena, char op, ASTNode* lhs, ASTNode* rhs) {
+    if (!ast_is_expr(lhs) || !ast_is_expr(rhs)) { return NULL; }
+
+    ASTNode* new_binary_op_node = arena_alloc(arena, sizeof(ASTNode));
+    if (!new_binary_op_node) { return NULL; }
+
+    new_binary_op_node->type = AST_BINARY_OP;
+    new_binary_op_node->value.binary_op.op = op;
+    new_binary_op_node->value.binary_op.lhs = lhs;
+    new_binary_op_node->value.binary_op.rhs = rhs;
+    new_binary_op_node->next = NULL;
+
+    return new_binary_op_node;
+}
+
+int ast_is_expr(ASTNode* node) {
+    if (!node) { return 0; }
+
+    return (node->type == AST_LITERAL || node->type == AST_IDENTIFIER || node->type == AST_BINARY_OP || node->type == AST_FUNCTION_CALL);
+}
+
+void print_ast(FILE* out, ASTNode* root) {
     if (root->type != AST_PROGRAM) {
-        printf("Top level root must be of type AST_PROGRAM\n");
-        exit(EXIT_FAILURE);
+        fprintf(out, "Top level root must be of type AST_PROGRAM\n");
+        return;
     }
 
-    printf("Program -> %p\n", root);
+    fprintf(out, "Program -> %p\n", root);
     ASTNode* current_node = root->value.program.functions;
-    print_ast_node(current_node);
+    print_ast_node(out, current_node);
     while (current_node->next) {
         current_node = current_node->next;
-        print_ast_node(current_node);
+        print_ast_node(out, current_node);
     }
 }
 
-void print_ast_node(ASTNode* node) {
+void print_ast_node(FILE* out, ASTNode* node) {
     switch(node->type) {
         case AST_FUNCTION_DECL:
-            print_ast_fn_decl(node);
+            print_ast_fn_decl(out, node);
             break;
         case AST_VARIABLE_DECL:
-            print_ast_var_decl(node);
+            print_ast_var_decl(out, node);
             break;
         case AST_RETURN_STMT:
-            print_ast_ret_stmt(node);
+            print_ast_ret_stmt(out, node);
+            break;
+        case AST_FUNCTION_CALL:
+            fprintf(out, "Call: ");
+            print_ast_expr(out, node);
+            fprintf(out, "\n");
             break;
         default:
-            printf("Type (%d) not supported in a body\n", node->type);
+            fprintf(out, "Type (%d) not supported in a body\n", node->type);
     }
 }
 
-void print_ast_fn_decl(ASTNode* node) {
+void print_ast_fn_decl(FILE* out, ASTNode* node) {
     if (node->type != AST_FUNCTION_DECL) {
-        printf("To printf function decl you pust give a function decl\n");
-        exit(EXIT_FAILURE);
+        fprintf(out, "To printf function decl you pust give a function decl\n");
+        return;
     }
 
-    printf("|-- Function def: Name -> %s, Return -> %s, Body -> %p\n", node->value.function_decl.name, node->value.function_decl.return_type, node->value.function_decl.body);
+    fprintf(out, "|-- Function def: Name -> %s, Params -> (", node->value.function_decl.name);
+    for (ASTNode* param = node->value.function_decl.params; param; param = param->next) {
+        fprintf(out, "%s: %s%s", param->value.parameter.name, param->value.parameter.type, param->next ? ", " : "");
+    }
+    fprintf(out, "), Return -> %s, Body -> %p\n", node->value.function_decl.return_type, node->value.function_decl.body);
     ASTNode* current_body_node = node->value.function_decl.body;
-    printf("    |-- ");
-    print_ast_node(current_body_node);
+    fprintf(out, "    |-- ");
+    print_ast_node(out, current_body_node);
 
     while (current_body_node->next) {
         current_body_node = current_body_node->next;
-        printf("    |-- ");
-        print_ast_node(current_body_node);
+        fprintf(out, "    |-- ");
+        print_ast_node(out, current_body_node);
     }
 }
 
-void print_ast_var_decl(ASTNode* node) {
+void print_ast_var_decl(FILE* out, ASTNode* node) {
     if (node->type != AST_VARIABLE_DECL) {
-        printf("To print variable decl you pust give a variable decl\n");
-        exit(EXIT_FAILURE);
+        fprintf(out, "To print variable decl you pust give a variable decl\n");
+        return;
     }
 
-    printf("Var definition: Name -> %s, Type -> %s, Value -> %d\n", node->value.variable_decl.name, node->value.variable_decl.type, node->value.variable_decl.value->value.literal.int_value);
+    fprintf(out, "Var definition: Name -> %s, Type -> %s, Value -> ", node->value.variable_decl.name, node->value.variable_decl.type);
+    print_ast_expr(out, node->value.variable_decl.value);
+    fprintf(out, "\n");
 }
 
-void print_ast_ret_stmt(ASTNode* node) {
+void print_ast_ret_stmt(FILE* out, ASTNode* node) {
     if (node->type != AST_RETURN_STMT) {
-        printf("To print return stmt you pust give a return stmt, (%d)\n", node->type);
-        exit(EXIT_FAILURE);
+        fprintf(out, "To print return stmt you pust give a return stmt, (%d)\n", node->type);
+        return;
     }
 
-    printf("Return Stmt: Value -> %d, Type -> %s\n", node->value.return_stmt.value->value.literal.int_value, node->value.return_stmt.value->value.literal.type);
+    fprintf(out, "Return Stmt: Value -> ");
+    print_ast_expr(out, node->value.return_stmt.value);
+    fprintf(out, "\n");
+}
+
+void print_ast_expr(FILE* out, ASTNode* node) {
+    switch (node->type) {
+        case AST_LITERAL:
+            fprintf(out, "%d", node->value.literal.int_value);
+            break;
+        case AST_IDENTIFIER:
+            fprintf(out, "%s", node->value.identifier.name);
+            break;
+        case AST_BINARY_OP:
+            fprintf(out, "(");
+            print_ast_expr(out, node->value.binary_op.lhs);
+            fprintf(out, " %c ", node->value.binary_op.op);
+            print_ast_expr(out, node->value.binary_op.rhs);
+            fprintf(out, ")");
+            break;
+        case AST_FUNCTION_CALL:
+            fprintf(out, "%s(", node->value.function_call.name);
+            for (ASTNode* arg = node->value.function_call.args; arg; arg = arg->next) {
+                print_ast_expr(out, arg);
+                if (arg->next) { fprintf(out, ", "); }
+            }
+            fprintf(out, ")");
+            break;
+        default:
+            fprintf(out, "<type (%d) is not an expression>", node->type);
+    }
 }
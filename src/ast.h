@@ -2,15 +2,19 @@
 #define Q_AST_H
 #include "stdio.h"
 #include "stdlib.h"
+#include "arena.h"
 
 // ----- AST -----
 typedef enum {
     AST_PROGRAM = 0,
     AST_FUNCTION_DECL,
-    //AST_FUNCTION_CALL,
+    AST_FUNCTION_CALL,
+    AST_PARAMETER,
     AST_VARIABLE_DECL,
     AST_RETURN_STMT,
     AST_LITERAL,
+    AST_IDENTIFIER,
+    AST_BINARY_OP,
     AST_NONE,
 } ASTNodeType;
 
@@ -23,10 +27,23 @@ typedef union {
 
     struct {
         const char* name;
+        struct ASTNode* params;
+        int param_count;
         const char* return_type;
         struct ASTNode* body;
     } function_decl;
 
+    struct {
+        const char* name;
+        struct ASTNode* args;
+        int arg_count;
+    } function_call;
+
+    struct {
+        const char* name;
+        const char* type;
+    } parameter;
+
     struct {
         // TODO: Make const a possible thing.
         // bool mut;
@@ -43,6 +60,17 @@ typedef union {
         int int_value;
         const char* type;
     } literal;
+
+    struct {
+        const char* name;
+    } identifier;
+
+    struct {
+        // One of '+', '-' or '*'.
+        char op;
+        struct ASTNode* lhs;
+        struct ASTNode* rhs;
+    } binary_op;
 } ASTNodeValue;
 
 typedef struct ASTNode {
@@ -51,18 +79,28 @@ typedef struct ASTNode {
     struct ASTNode* next;
 } ASTNode;
 
-ASTNode* ast_init();
+// Nodes are allocated from the given arena and freed along with it. Every
+// create function returns NULL when it is out of memory or given a node of
+// the wrong kind.
+ASTNode* ast_init(Arena* arena);
 void ast_append_node(ASTNode** branch_root, ASTNode* node_to_append);
-ASTNode* ast_create_empty();
-ASTNode* ast_create_fn_decl(const char* name, const char* return_type, ASTNode* body);
-ASTNode* ast_create_var_decl(const char* name, const char* type, ASTNode* value);
-ASTNode* ast_create_literal(const char* type, int value);
-ASTNode* ast_create_return_stmt(ASTNode* value);
+ASTNode* ast_create_empty(Arena* arena);
+ASTNode* ast_create_fn_decl(Arena* arena, const char* name, ASTNode* params, int param_count, const char* return_type, ASTNode* body);
+ASTNode* ast_create_fn_call(Arena* arena, const char* name, ASTNode* args, int arg_count);
+ASTNode* ast_create_param(Arena* arena, const char* name, const char* type);
+ASTNode* ast_create_var_decl(Arena* arena, const char* name, const char* type, ASTNode* value);
+ASTNode* ast_create_literal(Arena* arena, const char* type, int value);
+ASTNode* ast_create_return_stmt(Arena* arena, ASTNode* value);
+ASTNode* ast_create_identifier(Arena* arena, const char* name);
+ASTNode* ast_create_binary_op(Arena* arena, char op, ASTNode* lhs, ASTNode* rhs);
+
+int ast_is_expr(ASTNode* node);
 
-void print_ast(ASTNode* root);
-void print_ast_node(ASTNode* node);
-void print_ast_fn_decl(ASTNode* node);
-void print_ast_var_decl(ASTNode* node);
-void print_ast_ret_stmt(ASTNode* node);
+void print_ast(FILE* out, ASTNode* root);
+void print_ast_node(FILE* out, ASTNode* node);
+void print_ast_fn_decl(FILE* out, ASTNode* node);
+void print_ast_var_decl(FILE* out, ASTNode* node);
+void print_ast_ret_stmt(FILE* out, ASTNode* node);
+void print_ast_expr(FILE* out, ASTNode* node);
 
 #endif
@@ -0,0 +1,118 @@
+#include "callgraph.h"
+
+// ----- CALL GRAPH -----
+static bool callgraph_add_edge(CallGraphNode* node, int callee) {
+    if (node->length >= node->capacity) {
+        size_t capacity = node->capacity ? node->capacity * 2 : 4;
+        int* callees = realloc(node->callees, capacity * sizeof(int));
+        if (!callees) { return false; }
+
+        node->callees = callees;
+        node->capacity = capacity;
+    }
+
+    node->callees[node->length] = callee;
+    node->length++;
+
+    return true;
+}
+
+CallGraph* callgraph_build(IRModule* module) {
+    CallGraph* new_graph = malloc(sizeof(CallGraph));
+    if (!new_graph) { return NULL; }
+
+    new_graph->length = module->length;
+    new_graph->nodes = calloc(new_graph->length ? new_graph->length : 1, sizeof(CallGraphNode));
+    if (!new_graph->nodes) {
+        free(new_graph);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < module->length; i++) {
+        IRFunction* function = &module->functions[i];
+        for (size_t j = 0; j < function->block_count; j++) {
+            IRBlock* block = &function->blocks[j];
+            for (size_t k = 0; k < block->length; k++) {
+                if (block->instrs[k].op != IR_CALL) { continue; }
+
+                if (!callgraph_add_edge(&new_graph->nodes[i], block->instrs[k].imm)) {
+                    free_callgraph(new_graph);
+                    return NULL;
+                }
+                new_graph->nodes[block->instrs[k].imm].caller_count++;
+            }
+        }
+    }
+
+    return new_graph;
+}
+
+// Returns every function index ordered so callees come before their callers.
+// Functions in a cycle are ordered by whichever one the walk reached first.
+int* callgraph_bottom_up_order(CallGraph* graph) {
+    int* order = malloc(graph->length * sizeof(int));
+    bool* visited = calloc(graph->length, sizeof(bool));
+    int* stack = malloc(graph->length * sizeof(int));
+    size_t* next_edge = calloc(graph->length, sizeof(size_t));
+    if (graph->length && (!order || !visited || !stack || !next_edge)) {
+        free(order);
+        free(visited);
+        free(stack);
+        free(next_edge);
+        return NULL;
+    }
+
+    size_t order_length = 0;
+    for (size_t root = 0; root < graph->length; root++) {
+        if (visited[root]) { continue; }
+
+        size_t stack_length = 0;
+        visited[root] = true;
+        stack[stack_length++] = (int)root;
+
+        while (stack_length > 0) {
+            int current = stack[stack_length - 1];
+            CallGraphNode* node = &graph->nodes[current];
+
+            if (next_edge[current] < node->length) {
+                int callee = node->callees[next_edge[current]++];
+                if (!visited[callee]) {
+                    visited[callee] = true;
+                    stack[stack_length++] = callee;
+                }
+                continue;
+            }
+
+            order[order_length++] = current;
+            stack_length--;
+        }
+    }
+
+    free(visited);
+    free(stack);
+    free(next_edge);
+
+    return order;
+}
+
+void free_callgraph(CallGraph* graph) {
+    if (!graph) { return; }
+
+    for (size_t i = 0; i < graph->length; i++) {
+        free(graph->nodes[i].callees);
+    }
+
+    free(graph->nodes);
+    free(graph);
+}
+
+void print_callgraph(FILE* out, CallGraph* graph, IRModule* module) {
+    for (size_t i = 0; i < graph->length; i++) {
+        CallGraphNode* node = &graph->nodes[i];
+        fprintf(out, "%s (callers: %d) ->", module->functions[i].name, node->caller_count);
+        for (size_t j = 0; j < node->length; j++) {
+            fprintf(out, " %s", module->functions[node->callees[j]].name);
+        }
+        fprintf(out, "\n");
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef Q_CALLGRAPH_H
+#define Q_CALLGRAPH_H
+#include "ir.h"
+
+// ----- CALL GRAPH -----
+// Nodes line up with the module's function array. Edges are kept per call
+// site, so a function calling the same helper twice has two edges to it.
+typedef struct {
+    int* callees;
+    size_t length;
+    size_t capacity;
+    int caller_count;
+} CallGraphNode;
+
+typedef struct {
+    CallGraphNode* nodes;
+    size_t length;
+} CallGraph;
+
+// Both return NULL when out of memory.
+CallGraph* callgraph_build(IRModule* module);
+int* callgraph_bottom_up_order(CallGraph* graph);
+void free_callgraph(CallGraph* graph);
+void print_callgraph(FILE* out, CallGraph* graph, IRModule* module);
+
+#endif
@@ -0,0 +1,95 @@
+#include "diagnostics.h"
+
+// ----- STATUS -----
+const char* quark_status_name(QuarkStatus status) {
+    switch (status) {
+        case QUARK_OK: return "ok";
+        case QUARK_ERROR_INVALID_ARGUMENT: return "invalid argument";
+        case QUARK_ERROR_OUT_OF_MEMORY: return "out of memory";
+        case QUARK_ERROR_SYNTAX: return "syntax error";
+        case QUARK_ERROR_SEMANTIC: return "semantic error";
+        default: return "unknown error";
+    }
+}
+
+// ----- DIAGNOSTICS -----
+void diagnostics_init(Diagnostics* diagnostics) {
+    diagnostics->items = NULL;
+    diagnostics->length = 0;
+    diagnostics->capacity = 0;
+    diagnostics->status = QUARK_OK;
+}
+
+static void diagnostics_push(Diagnostics* diagnostics, Diagnostic diagnostic) {
+    if (diagnostics->status == QUARK_OK) {
+        diagnostics->status = diagnostic.status;
+    }
+
+    if (diagnostics->length >= diagnostics->capacity) {
+        size_t capacity = diagnostics->capacity ? diagnostics->capacity * 2 : 4;
+        Diagnostic* items = realloc(diagnostics->items, capacity * sizeof(Diagnostic));
+        if (!items) {
+            // The status above still records that something failed.
+            free(diagnostic.message);
+            return;
+        }
+
+        diagnostics->items = items;
+        diagnostics->capacity = capacity;
+    }
+
+    diagnostics->items[diagnostics->length] = diagnostic;
+    diagnostics->length++;
+}
+
+// Records an error and hands its status back so callers can return it.
+QuarkStatus diagnostics_report(Diagnostics* diagnostics, QuarkStatus status, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    Diagnostic diagnostic = { .status = status, .message = NULL };
+    if (length >= 0) {
+        diagnostic.message = malloc((size_t)length + 1);
+    }
+    if (diagnostic.message) {
+        va_start(args, format);
+        vsnprintf(diagnostic.message, (size_t)length + 1, format, args);
+        va_end(args);
+    }
+
+    diagnostics_push(diagnostics, diagnostic);
+
+    return status;
+}
+
+// Moves every diagnostic out of from and onto the end of diagnostics.
+void diagnostics_take(Diagnostics* diagnostics, Diagnostics* from) {
+    for (size_t i = 0; i < from->length; i++) {
+        diagnostics_push(diagnostics, from->items[i]);
+    }
+
+    if (diagnostics->status == QUARK_OK) {
+        diagnostics->status = from->status;
+    }
+
+    from->length = 0;
+    from->status = QUARK_OK;
+}
+
+// Drops every diagnostic but keeps the storage for the next compile.
+void diagnostics_clear(Diagnostics* diagnostics) {
+    for (size_t i = 0; i < diagnostics->length; i++) {
+        free(diagnostics->items[i].message);
+    }
+
+    diagnostics->length = 0;
+    diagnostics->status = QUARK_OK;
+}
+
+void free_diagnostics(Diagnostics* diagnostics) {
+    diagnostics_clear(diagnostics);
+    free(diagnostics->items);
+    diagnostics_init(diagnostics);
+}
@@ -0,0 +1,41 @@
+#ifndef Q_DIAGNOSTICS_H
+#define Q_DIAGNOSTICS_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+// ----- STATUS -----
+typedef enum {
+    QUARK_OK = 0,
+    QUARK_ERROR_INVALID_ARGUMENT,
+    QUARK_ERROR_OUT_OF_MEMORY,
+    QUARK_ERROR_SYNTAX,
+    QUARK_ERROR_SEMANTIC,
+} QuarkStatus;
+
+const char* quark_status_name(QuarkStatus status);
+
+// ----- DIAGNOSTICS -----
+typedef struct {
+    QuarkStatus status;
+    // NULL when there was no memory left to format the message.
+    char* message;
+} Diagnostic;
+
+// Keeps every error reported during a compile in the order it was reported.
+// The status is the first error seen, so later errors never hide the cause.
+typedef struct {
+    Diagnostic* items;
+    size_t length;
+    size_t capacity;
+    QuarkStatus status;
+} Diagnostics;
+
+void diagnostics_init(Diagnostics* diagnostics);
+QuarkStatus diagnostics_report(Diagnostics* diagnostics, QuarkStatus status, const char* format, ...);
+void diagnostics_take(Diagnostics* diagnostics, Diagnostics* from);
+void diagnostics_clear(Diagnostics* diagnostics);
+void free_diagnostics(Diagnostics* diagnostics);
+
+#endif
@@ -0,0 +1,306 @@
+#include "ir.h"
+
+// ----- IR TYPES -----
+// Returns false when the name is not a supported type.
+bool ir_type_from_name(const char* name, IRType* type) {
+    if (name && strcmp(name, "i32") == 0) {
+        *type = IR_TYPE_I32;
+        return true;
+    }
+
+    return false;
+}
+
+const char* ir_type_name(IRType type) {
+    switch (type) {
+        case IR_TYPE_VOID: return "void";
+        case IR_TYPE_I32: return "i32";
+        default: return "?";
+    }
+}
+
+// ----- IR INSTRUCTIONS -----
+bool ir_instr_is_pure(IRInstr* instr) {
+    switch (instr->op) {
+        case IR_CONST:
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_LOAD:
+        case IR_PARAM:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ----- IR BLOCK -----
+bool ir_block_append(IRBlock* block, IRInstr instr) {
+    if (block->length >= block->capacity) {
+        size_t capacity = block->capacity ? block->capacity * 2 : 8;
+        IRInstr* instrs = realloc(block->instrs, capacity * sizeof(IRInstr));
+        if (!instrs) { return false; }
+
+        block->instrs = instrs;
+        block->capacity = capacity;
+    }
+
+    block->instrs[block->length] = instr;
+    block->length++;
+
+    return true;
+}
+
+// Drops every IR_NOP left behind by a pass, returning how many were removed.
+size_t ir_block_compact(IRBlock* block) {
+    size_t kept = 0;
+    for (size_t i = 0; i < block->length; i++) {
+        if (block->instrs[i].op == IR_NOP) { continue; }
+
+        block->instrs[kept] = block->instrs[i];
+        kept++;
+    }
+
+    size_t removed = block->length - kept;
+    block->length = kept;
+
+    return removed;
+}
+
+// ----- IR FUNCTION -----
+bool ir_function_add_param(IRFunction* function, IRType type) {
+    if (function->param_count >= function->param_capacity) {
+        int capacity = function->param_capacity ? function->param_capacity * 2 : 4;
+        IRType* param_types = realloc(function->param_types, capacity * sizeof(IRType));
+        if (!param_types) { return false; }
+
+        function->param_types = param_types;
+        function->param_capacity = capacity;
+    }
+
+    function->param_types[function->param_count] = type;
+    function->param_count++;
+
+    return true;
+}
+
+int ir_function_add_block(IRFunction* function) {
+    if (function->block_count >= function->block_capacity) {
+        size_t capacity = function->block_capacity ? function->block_capacity * 2 : 1;
+        IRBlock* blocks = realloc(function->blocks, capacity * sizeof(IRBlock));
+        if (!blocks) { return -1; }
+
+        function->blocks = blocks;
+        function->block_capacity = capacity;
+    }
+
+    IRBlock* block = &function->blocks[function->block_count];
+    block->instrs = NULL;
+    block->length = 0;
+    block->capacity = 0;
+
+    return (int)function->block_count++;
+}
+
+int ir_function_new_reg(IRFunction* function, IRType type) {
+    if (function->reg_count >= function->reg_capacity) {
+        int capacity = function->reg_capacity ? function->reg_capacity * 2 : 8;
+        IRType* reg_types = realloc(function->reg_types, capacity * sizeof(IRType));
+        if (!reg_types) { return -1; }
+
+        function->reg_types = reg_types;
+        function->reg_capacity = capacity;
+    }
+
+    function->reg_types[function->reg_count] = type;
+    return function->reg_count++;
+}
+
+int ir_function_add_slot(IRFunction* function, const char* name, IRType type) {
+    if (function->slot_count >= function->slot_capacity) {
+        int capacity = function->slot_capacity ? function->slot_capacity * 2 : 4;
+        IRSlot* slots = realloc(function->slots, capacity * sizeof(IRSlot));
+        if (!slots) { return -1; }
+
+        function->slots = slots;
+        function->slot_capacity = capacity;
+    }
+
+    function->slots[function->slot_count].name = name;
+    function->slots[function->slot_count].type = type;
+    return function->slot_count++;
+}
+
+size_t ir_function_instr_count(IRFunction* function) {
+    size_t count = 0;
+    for (size_t i = 0; i < function->block_count; i++) {
+        count += function->blocks[i].length;
+    }
+
+    return count;
+}
+
+void free_ir_function(IRFunction* function) {
+    for (size_t i = 0; i < function->block_count; i++) {
+        free(function->blocks[i].instrs);
+    }
+
+    free(function->param_types);
+    free(function->blocks);
+    free(function->reg_types);
+    free(function->slots);
+}
+
+// ----- IR MODULE -----
+IRModule* ir_module_init(size_t capacity) {
+    IRModule* new_module = malloc(sizeof(IRModule));
+    if (!new_module) { return NULL; }
+
+    new_module->capacity = capacity ? capacity : 1;
+    new_module->length = 0;
+    new_module->functions = calloc(new_module->capacity, sizeof(IRFunction));
+
+    if (!new_module->functions) {
+        free(new_module);
+        return NULL;
+    }
+
+    return new_module;
+}
+
+// The returned pointer is only valid until the next function is added.
+IRFunction* ir_module_add_function(IRModule* module, const char* name, IRType return_type) {
+    if (module->length >= module->capacity) {
+        IRFunction* functions = realloc(module->functions, module->capacity * 2 * sizeof(IRFunction));
+        if (!functions) { return NULL; }
+
+        module->functions = functions;
+        module->capacity = module->capacity * 2;
+    }
+
+    IRFunction* function = &module->functions[module->length];
+    memset(function, 0, sizeof(IRFunction));
+    function->name = name;
+    function->return_type = return_type;
+    module->length++;
+
+    return function;
+}
+
+int ir_module_find_function(IRModule* module, const char* name) {
+    for (size_t i = 0; i < module->length; i++) {
+        if (strcmp(module->functions[i].name, name) == 0) { return (int)i; }
+    }
+
+    return -1;
+}
+
+size_t ir_module_instr_count(IRModule* module) {
+    size_t count = 0;
+    for (size_t i = 0; i < module->length; i++) {
+        count += ir_function_instr_count(&module->functions[i]);
+    }
+
+    return count;
+}
+
+// Frees every function whose remap entry is -1, compacting the rest in source
+// order and retargeting calls. On return remap holds each kept function's new
+// index. Returns how many were removed.
+size_t ir_module_remove_functions(IRModule* module, int* remap) {
+    size_t kept = 0;
+    for (size_t i = 0; i < module->length; i++) {
+        if (remap[i] < 0) {
+            free_ir_function(&module->functions[i]);
+            remap[i] = -1;
+            continue;
+        }
+
+        remap[i] = (int)kept;
+        module->functions[kept] = module->functions[i];
+        kept++;
+    }
+
+    size_t removed = module->length - kept;
+    module->length = kept;
+
+    if (removed > 0) {
+        for (size_t i = 0; i < module->length; i++) {
+            IRFunction* function = &module->functions[i];
+            for (size_t j = 0; j < function->block_count; j++) {
+                IRBlock* block = &function->blocks[j];
+                for (size_t k = 0; k < block->length; k++) {
+                    if (block->instrs[k].op == IR_CALL) { block->instrs[k].imm = remap[block->instrs[k].imm]; }
+                }
+            }
+        }
+    }
+
+    return removed;
+}
+
+// Frees every function but keeps the function array for the next compile.
+void ir_module_clear(IRModule* module) {
+    for (size_t i = 0; i < module->length; i++) {
+        free_ir_function(&module->functions[i]);
+    }
+
+    module->length = 0;
+}
+
+void free_ir_module(IRModule* module) {
+    if (!module) { return; }
+
+    ir_module_clear(module);
+    free(module->functions);
+    free(module);
+}
+
+void print_ir_module(FILE* out, IRModule* module) {
+    for (size_t i = 0; i < module->length; i++) {
+        if (i > 0) { fprintf(out, "\n"); }
+        print_ir_function(out, module, &module->functions[i]);
+    }
+}
+
+void print_ir_function(FILE* out, IRModule* module, IRFunction* function) {
+    fprintf(out, "fn %s(", function->name);
+    for (int i = 0; i < function->param_count; i++) {
+        fprintf(out, "%s%s", ir_type_name(function->param_types[i]), i + 1 < function->param_count ? ", " : "");
+    }
+    fprintf(out, ") -> %s {\n", ir_type_name(function->return_type));
+
+    for (size_t i = 0; i < function->block_count; i++) {
+        fprintf(out, "  bb%zu:\n", i);
+
+        IRBlock* block = &function->blocks[i];
+        for (size_t j = 0; j < block->length; j++) {
+            fprintf(out, "    ");
+            print_ir_instr(out, module, function, &block->instrs[j]);
+        }
+    }
+
+    fprintf(out, "}\n");
+}
+
+void print_ir_instr(FILE* out, IRModule* module, IRFunction* function, IRInstr* instr) {
+    if (instr->dest != IR_NO_REG) {
+        fprintf(out, "%%%d: %s = ", instr->dest, ir_type_name(instr->type));
+    }
+
+    switch (instr->op) {
+        case IR_NOP: fprintf(out, "nop\n"); break;
+        case IR_CONST: fprintf(out, "const %d\n", instr->imm); break;
+        case IR_ADD: fprintf(out, "add %%%d, %%%d\n", instr->a, instr->b); break;
+        case IR_SUB: fprintf(out, "sub %%%d, %%%d\n", instr->a, instr->b); break;
+        case IR_MUL: fprintf(out, "mul %%%d, %%%d\n", instr->a, instr->b); break;
+        case IR_LOAD: fprintf(out, "load $%s\n", function->slots[instr->imm].name); break;
+        case IR_STORE: fprintf(out, "store $%s, %%%d\n", function->slots[instr->imm].name, instr->a); break;
+        case IR_PARAM: fprintf(out, "param %d\n", instr->imm); break;
+        case IR_ARG: fprintf(out, "arg %d, %%%d\n", instr->imm, instr->a); break;
+        case IR_CALL: fprintf(out, "call %s\n", module->functions[instr->imm].name); break;
+        case IR_RET: fprintf(out, "ret %%%d\n", instr->a); break;
+        default:
+            fprintf(out, "<opcode (%d) not supported>\n", instr->op);
+    }
+}
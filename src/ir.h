@@ -0,0 +1,112 @@
+#ifndef Q_IR_H
+#define Q_IR_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// ----- IR TYPES -----
+typedef enum {
+    IR_TYPE_VOID = 0,
+    IR_TYPE_I32,
+} IRType;
+
+bool ir_type_from_name(const char* name, IRType* type);
+const char* ir_type_name(IRType type);
+
+// ----- IR INSTRUCTIONS -----
+typedef enum {
+    IR_NOP = 0,
+    IR_CONST,   // dest = imm
+    IR_ADD,     // dest = a + b
+    IR_SUB,     // dest = a - b
+    IR_MUL,     // dest = a * b
+    IR_LOAD,    // dest = slot[imm]
+    IR_STORE,   // slot[imm] = a
+    IR_PARAM,   // dest = params[imm]
+    IR_ARG,     // args[imm] = a, always directly before its IR_CALL
+    IR_CALL,    // dest = functions[imm](args...)
+    IR_RET,     // return a
+} IROpcode;
+
+#define IR_NO_REG -1
+
+// Every operand is a virtual register index into the owning function, so an
+// instruction is a fixed size record and a block is a flat array of them.
+typedef struct {
+    IROpcode op;
+    IRType type;
+    int dest;
+    int a;
+    int b;
+    int imm;
+} IRInstr;
+
+bool ir_instr_is_pure(IRInstr* instr);
+
+// ----- IR BLOCK -----
+typedef struct {
+    IRInstr* instrs;
+    size_t length;
+    size_t capacity;
+} IRBlock;
+
+// Everything that allocates reports failure through its return value: false,
+// -1 or NULL, leaving the IR as it was before the call.
+bool ir_block_append(IRBlock* block, IRInstr instr);
+size_t ir_block_compact(IRBlock* block);
+
+// ----- IR FUNCTION -----
+typedef struct {
+    const char* name;
+    IRType type;
+} IRSlot;
+
+typedef struct {
+    const char* name;
+    IRType return_type;
+
+    IRType* param_types;
+    int param_count;
+    int param_capacity;
+
+    IRBlock* blocks;
+    size_t block_count;
+    size_t block_capacity;
+
+    IRType* reg_types;
+    int reg_count;
+    int reg_capacity;
+
+    IRSlot* slots;
+    int slot_count;
+    int slot_capacity;
+} IRFunction;
+
+bool ir_function_add_param(IRFunction* function, IRType type);
+int ir_function_add_block(IRFunction* function);
+int ir_function_new_reg(IRFunction* function, IRType type);
+int ir_function_add_slot(IRFunction* function, const char* name, IRType type);
+size_t ir_function_instr_count(IRFunction* function);
+void free_ir_function(IRFunction* function);
+
+// ----- IR MODULE -----
+typedef struct {
+    IRFunction* functions;
+    size_t length;
+    size_t capacity;
+} IRModule;
+
+IRModule* ir_module_init(size_t capacity);
+IRFunction* ir_module_add_function(IRModule* module, const char* name, IRType return_type);
+int ir_module_find_function(IRModule* module, const char* name);
+size_t ir_module_instr_count(IRModule* module);
+size_t ir_module_remove_functions(IRModule* module, int* remap);
+void ir_module_clear(IRModule* module);
+void free_ir_module(IRModule* module);
+
+void print_ir_module(FILE* out, IRModule* module);
+void print_ir_function(FILE* out, IRModule* module, IRFunction* function);
+void print_ir_instr(FILE* out, IRModule* module, IRFunction* function, IRInstr* instr);
+
+#endif
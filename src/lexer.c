@@ -1,11 +1,8 @@
 #include "lexer.h"
 
-Token* token_init(TokenType type, char* value, int length) {
-    Token* token = malloc(sizeof(Token));
-    if (!token) {
-        printf("Failed to allocate token memory");
-        exit(EXIT_FAILURE);
-    }
+Token* token_init(Arena* arena, TokenType type, char* value, int length) {
+    Token* token = arena_alloc(arena, sizeof(Token));
+    if (!token) { return NULL; }
 
     token->type = type;
     token->value = value;
@@ -14,68 +11,94 @@ Token* token_init(TokenType type, char* value, int length) {
     return token;
 }
 
+const char* token_type_name(TokenType type) {
+    switch (type) {
+        case TOK_NONE: return "none";
+        case TOK_KEYWORD: return "keyword";
+        case TOK_ID: return "identifier";
+        case TOK_INT: return "integer";
+        case TOK_LPAREN: return "'('";
+        case TOK_RPAREN: return "')'";
+        case TOK_LBRACE: return "'{'";
+        case TOK_RBRACE: return "'}'";
+        case TOK_COLON: return "':'";
+        case TOK_SEMI: return "';'";
+        case TOK_EQUAL: return "'='";
+        case TOK_GT: return "'>'";
+        case TOK_ARROW: return "'->'";
+        case TOK_DASH: return "'-'";
+        case TOK_PLUS: return "'+'";
+        case TOK_STAR: return "'*'";
+        case TOK_COMMA: return "','";
+        case TOK_EOF: return "end of file";
+        default: return "unknown";
+    }
+}
+
 // ----- TOKEN ARRAY -----
 TokenArray* token_array_init(size_t capacity) {
     TokenArray* new_array = malloc(sizeof(TokenArray));
-    if (!new_array) {
-        printf("Failed to allocate memory for token array\n");
-        exit(EXIT_FAILURE);
-    }
+    if (!new_array) { return NULL; }
 
-    new_array->capacity = capacity;
+    new_array->capacity = capacity ? capacity : 1;
     new_array->length = 0;
     new_array->tokens = calloc(new_array->capacity, sizeof(Token*));
 
     if (!new_array->tokens) {
-        printf("Failed to allocate memory for new array tokens\n");
         free(new_array);
-        exit(EXIT_FAILURE);
+        return NULL;
     }
 
     return new_array;
 }
 
-void add_token(TokenArray* array, Token* token_to_add) {
-    if (token_to_add->type == TOK_NONE) {
-        printf("Token to add is of type 'TOK_NONE', token creation failed somwhere\n");
-        exit(EXIT_FAILURE);
-    }
-
+// Returns false when the array could not grow.
+bool add_token(TokenArray* array, Token* token_to_add) {
     if (array->length >= array->capacity) {
+        Token** tokens = realloc(array->tokens, array->capacity * 2 * sizeof(Token*));
+        if (!tokens) { return false; }
+
+        array->tokens = tokens;
         array->capacity = array->capacity * 2;
-        array->tokens = realloc(array->tokens, array->capacity * sizeof(Token));
-        if (!array->tokens) {
-            printf("Failed to reallocate token array tokens\n");
-            exit(EXIT_FAILURE);
-        }
     }
 
     array->tokens[array->length] = token_to_add;
     array->length++;
+
+    return true;
+}
+
+// Forgets every token but keeps the capacity for the next source.
+void token_array_clear(TokenArray* array) {
+    array->length = 0;
 }
 
 void free_token_array(TokenArray* array) {
-    if (!array) {
-        printf("There is no array to free\n");
-        return;
-    }
+    if (!array) { return; }
 
     free(array->tokens);
     free(array);
 }
 
-void print_token_array(TokenArray* array) {
-    printf("List Length: %ld\n", array->length);
+void print_token_array(FILE* out, TokenArray* array) {
+    fprintf(out, "List Length: %ld\n", array->length);
 
     for (int i = 0; i < array->length; i++) {
         Token* current_token = array->tokens[i];
-        printf("Token %d -> Type: %d, Value: %s, Length: %d\n", i, current_token->type, current_token->value, current_token->length);
+        fprintf(out, "Token %d -> Type: %d, Value: %s, Length: %d\n", i, current_token->type, current_token->value, current_token->length);
      }
 }
 
 // ----- Lexer -----
-void lexer_init(Lexer* lexer, const char* src) {
-    if (src == NULL) { printf("Invalid src for lexer init"); exit(EXIT_FAILURE); }
+QuarkStatus lexer_init(Lexer* lexer, const char* src, Arena* arena, Diagnostics* diagnostics) {
+    lexer->arena = arena;
+    lexer->diagnostics = diagnostics;
+    lexer->status = QUARK_OK;
+
+    if (src == NULL) {
+        lexer->status = diagnostics_report(diagnostics, QUARK_ERROR_INVALID_ARGUMENT, "Invalid src for lexer init");
+        return lexer->status;
+    }
 
     lexer->src = src;
     lexer->src_len = strlen(lexer->src);
@@ -83,11 +106,11 @@ void lexer_init(Lexer* lexer, const char* src) {
     lexer->current_char = lexer->src[lexer->position];
     lexer->line = 1;
     lexer->column = 1;
+
+    return QUARK_OK;
 }
 
 void lexer_advance(Lexer* lexer) {
-    if (lexer == NULL) { printf("Invalid lexer used"); exit(EXIT_FAILURE); }
-
     if (lexer->current_char == '\n') {
         lexer->line++;
         lexer->column = 0;
@@ -106,102 +129,128 @@ char lexer_peek_offset(Lexer* lexer, int offset) {
     return lexer->src[lexer->position + offset];
 }
 
-void lexer_get_tok_value(Lexer* lexer, Token* token) {
-    token->value = realloc(token->value, (token->length) + 2);
+// Makes a token out of everything between start and the current position.
+Token* lexer_token(Lexer* lexer, TokenType type, int start) {
+    int length = lexer->position - start;
+    char* value = arena_strndup(lexer->arena, lexer->src + start, length);
+    Token* token = value ? token_init(lexer->arena, type, value, length) : NULL;
 
-    if (!token->value) {
-        printf("Failed to reallocate memory for token\n");
-        free(token);
-        exit(EXIT_FAILURE);
+    if (!token) {
+        lexer->status = diagnostics_report(lexer->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for token");
     }
 
-    token->value[token->length] = lexer->current_char;
-
-    lexer_advance(lexer);
-    token->length++;
+    return token;
 }
 
 Token* lexer_eat_word(Lexer* lexer) {
-    // FIXME: Put this into a better function to include digit lexing.
-
-    Token* token = token_init(TOK_NONE, NULL, 0);
     int start = lexer->position;
 
     while (isalnum(lexer->current_char) || lexer->current_char == '_') {
-        lexer_get_tok_value(lexer, token);
+        lexer_advance(lexer);
     }
-    token->value[token->length] = '\0';
 
-    token->type = TOK_ID;
-
-    return token;
+    return lexer_token(lexer, TOK_ID, start);
 }
 
 Token* lexer_eat_digit(Lexer* lexer) {
-    // FIXME: Put this into a better function to include word lexing.
-
-    Token* token = token_init(TOK_NONE, NULL, 0);
-    token->type = TOK_INT;
-
     int start = lexer->position;
 
     while (isdigit(lexer->current_char) || lexer->current_char == '.') {
-        lexer_get_tok_value(lexer, token);
+        lexer_advance(lexer);
     }
-    token->value[token->length] = '\0';
 
-    return token;
+    return lexer_token(lexer, TOK_INT, start);
 }
 
 Token* lexer_eat_delim(Lexer* lexer) {
+    TokenType type;
+    char* value;
+
     switch (lexer->current_char) {
-        case ':': lexer_advance(lexer); return token_init(TOK_COLON, ":", 1);
-        case '(': lexer_advance(lexer); return token_init(TOK_LPAREN, "(", 1);
-        case ')': lexer_advance(lexer); return token_init(TOK_RPAREN, ")", 1);
-        case '{': lexer_advance(lexer); return token_init(TOK_LBRACE, "{", 1);
-        case '}': lexer_advance(lexer); return token_init(TOK_RBRACE, "}", 1);
-        case '=': lexer_advance(lexer); return token_init(TOK_EQUAL, "=", 1);
-        case ';': lexer_advance(lexer); return token_init(TOK_SEMI, ";", 1);
+        case ':': type = TOK_COLON; value = ":"; break;
+        case '(': type = TOK_LPAREN; value = "("; break;
+        case ')': type = TOK_RPAREN; value = ")"; break;
+        case '{': type = TOK_LBRACE; value = "{"; break;
+        case '}': type = TOK_RBRACE; value = "}"; break;
+        case '=': type = TOK_EQUAL; value = "="; break;
+        case ';': type = TOK_SEMI; value = ";"; break;
         case '-':
             if (lexer_peek_offset(lexer, 1) == '>') {
                 lexer_advance(lexer);
                 lexer_advance(lexer);
 
-                return token_init(TOK_ARROW, "->", 2);
+                Token* token = token_init(lexer->arena, TOK_ARROW, "->", 2);
+                if (!token) {
+                    lexer->status = diagnostics_report(lexer->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for token");
+                }
+                return token;
             }
 
-            return token_init(TOK_DASH, "-", 1);
+            type = TOK_DASH; value = "-";
+            break;
 
-        case '>': lexer_advance(lexer); return token_init(TOK_GT, ">", 1);
-        default: 
-            printf("Invalid delim character\n"); 
-            lexer_advance(lexer);
-            return token_init(TOK_NONE, NULL, 0);
+        case '>': type = TOK_GT; value = ">"; break;
+        case '+': type = TOK_PLUS; value = "+"; break;
+        case '*': type = TOK_STAR; value = "*"; break;
+        case ',': type = TOK_COMMA; value = ","; break;
+        default:
+            lexer->status = diagnostics_report(lexer->diagnostics, QUARK_ERROR_SYNTAX, "Invalid delim character '%c' at line %d, column %d", lexer->current_char, lexer->line, lexer->column);
+            return NULL;
+    }
+
+    lexer_advance(lexer);
+
+    Token* token = token_init(lexer->arena, type, value, 1);
+    if (!token) {
+        lexer->status = diagnostics_report(lexer->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for token");
     }
+
+    return token;
 }
 
 
 bool isdelim(int chr) {
-    return (chr == ':' || chr == '(' || chr == ')' || chr == '{' || chr == '}' || chr == '=' || chr == ';' || chr == '-' || chr == '>');
+    return (chr == ':' || chr == '(' || chr == ')' || chr == '{' || chr == '}' || chr == '=' || chr == ';' || chr == '-' || chr == '>' || chr == '+' || chr == '*' || chr == ',');
 }
 
 
-TokenArray* lex_src(Lexer* lexer) {
-    TokenArray* tokens = token_array_init(16);
+// Returns the next token, the EOF token once the source is used up or NULL
+// when lexing failed.
+Token* lexer_next_token(Lexer* lexer) {
+    if (lexer->status != QUARK_OK) { return NULL; }
+
     while (lexer->current_char != '\0') {
         if (isalpha(lexer->current_char)) {
-            add_token(tokens, lexer_eat_word(lexer));
+            return lexer_eat_word(lexer);
         } else if (isdigit(lexer->current_char)) {
-            add_token(tokens, lexer_eat_digit(lexer));
+            return lexer_eat_digit(lexer);
         } else if (isdelim(lexer->current_char)) {
-            add_token(tokens, lexer_eat_delim(lexer));
-        } else {
-            lexer_advance(lexer);
-            continue;
+            return lexer_eat_delim(lexer);
         }
+
+        lexer_advance(lexer);
+    }
+
+    Token* eof = token_init(lexer->arena, TOK_EOF, NULL, 0);
+    if (!eof) {
+        lexer->status = diagnostics_report(lexer->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for token");
     }
 
-    add_token(tokens, token_init(TOK_EOF, NULL, 0));
+    return eof;
+}
+
+QuarkStatus lex_src(Lexer* lexer, TokenArray* tokens) {
+    if (lexer->status != QUARK_OK) { return lexer->status; }
+
+    Token* token;
+    do {
+        token = lexer_next_token(lexer);
+        if (!token) { return lexer->status; }
+
+        if (!add_token(tokens, token)) {
+            return diagnostics_report(lexer->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to reallocate token array tokens");
+        }
+    } while (token->type != TOK_EOF);
 
-    return tokens;
+    return QUARK_OK;
 }
@@ -5,6 +5,8 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include "arena.h"
+#include "diagnostics.h"
 
 // ----- TOKEN -----
 typedef enum {
@@ -22,6 +24,9 @@ typedef enum {
     TOK_GT,
     TOK_ARROW,
     TOK_DASH,
+    TOK_PLUS,
+    TOK_STAR,
+    TOK_COMMA,
     TOK_EOF,
 } TokenType;
 
@@ -31,7 +36,8 @@ typedef struct {
     int length;
 } Token;
 
-Token* token_init(TokenType type, char* value, int length);
+Token* token_init(Arena* arena, TokenType type, char* value, int length);
+const char* token_type_name(TokenType type);
 
 // ----- TOKEN ARRAY -----
 typedef struct TokenArray {
@@ -41,9 +47,10 @@ typedef struct TokenArray {
 } TokenArray;
 
 TokenArray* token_array_init(size_t capacity);
-void add_token(TokenArray* array, Token* token_to_add);
+bool add_token(TokenArray* array, Token* token_to_add);
+void token_array_clear(TokenArray* array);
 void free_token_array(TokenArray* array);
-void print_token_array(TokenArray* array);
+void print_token_array(FILE* out, TokenArray* array);
 
 // ----- Lexer -----
 typedef struct {
@@ -53,17 +60,22 @@ typedef struct {
     int position;
     int line;
     int column;
+    // Tokens and their values live in the arena, errors go to diagnostics.
+    Arena* arena;
+    Diagnostics* diagnostics;
+    QuarkStatus status;
 } Lexer;
 
 bool isdelim(int chr);
 
-void lexer_init(Lexer* lexer, const char* src);
+QuarkStatus lexer_init(Lexer* lexer, const char* src, Arena* arena, Diagnostics* diagnostics);
 void lexer_advance(Lexer* lexer);
 char lexer_peek_offset(Lexer* lexer, int offset);
-void lexer_get_tok_value(Lexer* lexer, Token* token);
+Token* lexer_token(Lexer* lexer, TokenType type, int start);
 Token* lexer_eat_word(Lexer* lexer);
 Token* lexer_eat_digit(Lexer* lexer);
 Token* lexer_eat_delim(Lexer* lexer);
-TokenArray* lex_src(Lexer* lexer);
+Token* lexer_next_token(Lexer* lexer);
+QuarkStatus lex_src(Lexer* lexer, TokenArray* tokens);
 
 #endif // Lexer
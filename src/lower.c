@@ -0,0 +1,334 @@
+#include "lower.h"
+
+// ----- LOWERING -----
+// Every lower function returns -1 or false once it has reported an error.
+static int lower_out_of_memory(Lowerer* lowerer) {
+    diagnostics_report(lowerer->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory while lowering function %s", lowerer->function->name);
+    return -1;
+}
+
+int lower_lookup_slot(Lowerer* lowerer, const char* name) {
+    // Search newest first so a redeclared variable shadows the older one.
+    for (int i = lowerer->function->slot_count - 1; i >= 0; i--) {
+        if (strcmp(lowerer->function->slots[i].name, name) == 0) { return i; }
+    }
+
+    return -1;
+}
+
+int lower_emit(Lowerer* lowerer, IROpcode op, IRType type, int a, int b, int imm) {
+    int dest = IR_NO_REG;
+    if (type != IR_TYPE_VOID) {
+        dest = ir_function_new_reg(lowerer->function, type);
+        if (dest < 0) { return lower_out_of_memory(lowerer); }
+    }
+
+    IRInstr instr = { .op = op, .type = type, .dest = dest, .a = a, .b = b, .imm = imm };
+    if (!ir_block_append(&lowerer->function->blocks[lowerer->block], instr)) {
+        return lower_out_of_memory(lowerer);
+    }
+
+    // Void instructions have no register, hand back something that is not -1.
+    return dest == IR_NO_REG ? 0 : dest;
+}
+
+int lower_call(Lowerer* lowerer, ASTNode* node) {
+    const char* name = node->value.function_call.name;
+    int callee_index = symbol_table_find(lowerer->functions, name);
+    if (callee_index < 0) {
+        diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Call to undefined function %s in function %s", name, lowerer->function->name);
+        return -1;
+    }
+
+    IRFunction* callee = &lowerer->module->functions[callee_index];
+    if (node->value.function_call.arg_count != callee->param_count) {
+        diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Function %s expects %d arguments but is given %d", name, callee->param_count, node->value.function_call.arg_count);
+        return -1;
+    }
+
+    int* args = arena_alloc(lowerer->scratch, callee->param_count * sizeof(int));
+    if (!args) { return lower_out_of_memory(lowerer); }
+
+    // Evaluate every argument before emitting the args so they sit directly
+    // before the call.
+    int index = 0;
+    for (ASTNode* arg = node->value.function_call.args; arg; arg = arg->next) {
+        args[index] = lower_expr(lowerer, arg);
+        if (args[index] < 0) { return -1; }
+
+        if (lowerer->function->reg_types[args[index]] != callee->param_types[index]) {
+            diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Argument %d of %s must be %s but is given a %s", index, name, ir_type_name(callee->param_types[index]), ir_type_name(lowerer->function->reg_types[args[index]]));
+            return -1;
+        }
+        index++;
+    }
+
+    for (int i = 0; i < callee->param_count; i++) {
+        if (lower_emit(lowerer, IR_ARG, IR_TYPE_VOID, args[i], IR_NO_REG, i) < 0) { return -1; }
+    }
+
+    return lower_emit(lowerer, IR_CALL, callee->return_type, IR_NO_REG, IR_NO_REG, callee_index);
+}
+
+int lower_expr(Lowerer* lowerer, ASTNode* node) {
+    switch (node->type) {
+        case AST_LITERAL: {
+            IRType type;
+            if (!ir_type_from_name(node->value.literal.type, &type)) {
+                diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Type %s is not supported", node->value.literal.type);
+                return -1;
+            }
+
+            return lower_emit(lowerer, IR_CONST, type, IR_NO_REG, IR_NO_REG, node->value.literal.int_value);
+        }
+        case AST_IDENTIFIER: {
+            int slot = lower_lookup_slot(lowerer, node->value.identifier.name);
+            if (slot < 0) {
+                diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Use of undeclared variable %s in function %s", node->value.identifier.name, lowerer->function->name);
+                return -1;
+            }
+
+            IRType type = lowerer->function->slots[slot].type;
+            return lower_emit(lowerer, IR_LOAD, type, IR_NO_REG, IR_NO_REG, slot);
+        }
+        case AST_BINARY_OP: {
+            int lhs = lower_expr(lowerer, node->value.binary_op.lhs);
+            if (lhs < 0) { return -1; }
+            int rhs = lower_expr(lowerer, node->value.binary_op.rhs);
+            if (rhs < 0) { return -1; }
+
+            IROpcode op;
+            switch (node->value.binary_op.op) {
+                case '+': op = IR_ADD; break;
+                case '-': op = IR_SUB; break;
+                case '*': op = IR_MUL; break;
+                default:
+                    diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Binary operator %c is not supported", node->value.binary_op.op);
+                    return -1;
+            }
+
+            IRType type = lowerer->function->reg_types[lhs];
+            if (lowerer->function->reg_types[rhs] != type) {
+                diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Mismatched operand types for %c in function %s", node->value.binary_op.op, lowerer->function->name);
+                return -1;
+            }
+
+            return lower_emit(lowerer, op, type, lhs, rhs, 0);
+        }
+        case AST_FUNCTION_CALL:
+            return lower_call(lowerer, node);
+        default:
+            diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Type (%d) is not an expression", node->type);
+            return -1;
+    }
+}
+
+bool lower_stmt(Lowerer* lowerer, ASTNode* node) {
+    switch (node->type) {
+        case AST_VARIABLE_DECL: {
+            IRType type;
+            if (!ir_type_from_name(node->value.variable_decl.type, &type)) {
+                diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Variable %s has unsupported type %s", node->value.variable_decl.name, node->value.variable_decl.type);
+                return false;
+            }
+
+            int value = lower_expr(lowerer, node->value.variable_decl.value);
+            if (value < 0) { return false; }
+
+            if (lowerer->function->reg_types[value] != type) {
+                diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Variable %s is declared as %s but given a %s", node->value.variable_decl.name, ir_type_name(type), ir_type_name(lowerer->function->reg_types[value]));
+                return false;
+            }
+
+            int slot = ir_function_add_slot(lowerer->function, node->value.variable_decl.name, type);
+            if (slot < 0) {
+                lower_out_of_memory(lowerer);
+                return false;
+            }
+
+            return lower_emit(lowerer, IR_STORE, IR_TYPE_VOID, value, IR_NO_REG, slot) >= 0;
+        }
+        case AST_RETURN_STMT: {
+            int value = lower_expr(lowerer, node->value.return_stmt.value);
+            if (value < 0) { return false; }
+
+            if (lowerer->function->reg_types[value] != lowerer->function->return_type) {
+                diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Function %s returns %s but is given a %s", lowerer->function->name, ir_type_name(lowerer->function->return_type), ir_type_name(lowerer->function->reg_types[value]));
+                return false;
+            }
+
+            return lower_emit(lowerer, IR_RET, IR_TYPE_VOID, value, IR_NO_REG, 0) >= 0;
+        }
+        case AST_FUNCTION_CALL:
+            return lower_call(lowerer, node) >= 0;
+        case AST_NONE:
+            return true;
+        default:
+            diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Type (%d) not supported in a body", node->type);
+            return false;
+    }
+}
+
+bool lower_fn_decl(Lowerer* lowerer, ASTNode* node) {
+    lowerer->block = ir_function_add_block(lowerer->function);
+    if (lowerer->block < 0) {
+        lower_out_of_memory(lowerer);
+        return false;
+    }
+
+    // Parameters are stored into slots like any other variable and const-prop
+    // forwards them straight back out.
+    int param_index = 0;
+    for (ASTNode* param = node->value.function_decl.params; param; param = param->next) {
+        IRType type = lowerer->function->param_types[param_index];
+        int value = lower_emit(lowerer, IR_PARAM, type, IR_NO_REG, IR_NO_REG, param_index);
+        if (value < 0) { return false; }
+
+        int slot = ir_function_add_slot(lowerer->function, param->value.parameter.name, type);
+        if (slot < 0) {
+            lower_out_of_memory(lowerer);
+            return false;
+        }
+
+        if (lower_emit(lowerer, IR_STORE, IR_TYPE_VOID, value, IR_NO_REG, slot) < 0) { return false; }
+        param_index++;
+    }
+
+    ASTNode* current_node = node->value.function_decl.body;
+    while (current_node) {
+        if (!lower_stmt(lowerer, current_node)) { return false; }
+
+        // Anything after a return can never run.
+        if (current_node->type == AST_RETURN_STMT) { return true; }
+        current_node = current_node->next;
+    }
+
+    diagnostics_report(lowerer->diagnostics, QUARK_ERROR_SEMANTIC, "Function %s does not return a value", lowerer->function->name);
+    return false;
+}
+
+QuarkStatus lower_declare_fn(IRModule* module, SymbolTable* functions, ASTNode* node, Diagnostics* diagnostics) {
+    if (node->type != AST_FUNCTION_DECL) {
+        return diagnostics_report(diagnostics, QUARK_ERROR_SEMANTIC, "Type (%d) not supported at the top level", node->type);
+    }
+
+    const char* name = node->value.function_decl.name;
+    IRType return_type;
+    if (!ir_type_from_name(node->value.function_decl.return_type, &return_type)) {
+        return diagnostics_report(diagnostics, QUARK_ERROR_SEMANTIC, "Function %s has unsupported return type %s", name, node->value.function_decl.return_type);
+    }
+
+    int inserted = symbol_table_insert(functions, name, (int)module->length);
+    if (inserted == 0) {
+        return diagnostics_report(diagnostics, QUARK_ERROR_SEMANTIC, "Function %s is already defined", name);
+    }
+
+    IRFunction* function = inserted > 0 ? ir_module_add_function(module, name, return_type) : NULL;
+    if (!function) {
+        return diagnostics_report(diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for function %s", name);
+    }
+
+    for (ASTNode* param = node->value.function_decl.params; param; param = param->next) {
+        IRType type;
+        if (!ir_type_from_name(param->value.parameter.type, &type)) {
+            return diagnostics_report(diagnostics, QUARK_ERROR_SEMANTIC, "Parameter %s of %s has unsupported type %s", param->value.parameter.name, name, param->value.parameter.type);
+        }
+
+        if (!ir_function_add_param(function, type)) {
+            return diagnostics_report(diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for function %s", name);
+        }
+    }
+
+    return QUARK_OK;
+}
+
+typedef struct {
+    IRModule* module;
+    SymbolTable* functions;
+    ASTNode** decls;
+    Diagnostics* diagnostics;
+} LowerJob;
+
+static void lower_fn_task(void* context, size_t index, Arena* scratch) {
+    LowerJob* job = context;
+
+    Lowerer lowerer = {
+        .module = job->module,
+        .functions = job->functions,
+        .function = &job->module->functions[index],
+        .block = 0,
+        .scratch = scratch,
+        .diagnostics = &job->diagnostics[index],
+    };
+    lower_fn_decl(&lowerer, job->decls[index]);
+}
+
+// Lowers every function in root into module, which should be empty.
+QuarkStatus lower_program(ASTNode* root, ThreadPool* pool, IRModule* module, Diagnostics* diagnostics) {
+    if (!root || root->type != AST_PROGRAM) {
+        return diagnostics_report(diagnostics, QUARK_ERROR_INVALID_ARGUMENT, "Top level root must be of type AST_PROGRAM");
+    }
+
+    SymbolTable* functions = symbol_table_init(16);
+    size_t decl_capacity = 8;
+    ASTNode** decls = malloc(decl_capacity * sizeof(ASTNode*));
+    if (!functions || !decls) {
+        free_symbol_table(functions);
+        free(decls);
+        return diagnostics_report(diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for function decls");
+    }
+
+    // Declare every function first so bodies can call later ones.
+    QuarkStatus status = QUARK_OK;
+    for (ASTNode* node = root->value.program.functions; node && status == QUARK_OK; node = node->next) {
+        if (node->type == AST_NONE) { continue; }
+
+        status = lower_declare_fn(module, functions, node, diagnostics);
+        if (status != QUARK_OK) { break; }
+
+        if (module->length > decl_capacity) {
+            ASTNode** grown = realloc(decls, decl_capacity * 2 * sizeof(ASTNode*));
+            if (!grown) {
+                status = diagnostics_report(diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to reallocate function decls");
+                break;
+            }
+
+            decls = grown;
+            decl_capacity = decl_capacity * 2;
+        }
+        decls[module->length - 1] = node;
+    }
+
+    Diagnostics* function_diagnostics = NULL;
+    if (status == QUARK_OK) {
+        function_diagnostics = malloc((module->length ? module->length : 1) * sizeof(Diagnostics));
+        if (!function_diagnostics) {
+            status = diagnostics_report(diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for function diagnostics");
+        }
+    }
+
+    if (status == QUARK_OK) {
+        for (size_t i = 0; i < module->length; i++) {
+            diagnostics_init(&function_diagnostics[i]);
+        }
+
+        // Each task fills in the function at its own index, so the module
+        // and its diagnostics come out in source order however the tasks
+        // were scheduled.
+        LowerJob job = { .module = module, .functions = functions, .decls = decls, .diagnostics = function_diagnostics };
+        thread_pool_run(pool, module->length, lower_fn_task, &job);
+
+        for (size_t i = 0; i < module->length; i++) {
+            if (status == QUARK_OK) { status = function_diagnostics[i].status; }
+
+            diagnostics_take(diagnostics, &function_diagnostics[i]);
+            free_diagnostics(&function_diagnostics[i]);
+        }
+    }
+
+    free(function_diagnostics);
+    free(decls);
+    free_symbol_table(functions);
+
+    return status;
+}
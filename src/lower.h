@@ -0,0 +1,33 @@
+#ifndef Q_LOWER_H
+#define Q_LOWER_H
+#include "ast.h"
+#include "ir.h"
+#include "symbols.h"
+#include "threadpool.h"
+#include "diagnostics.h"
+
+// ----- LOWERING -----
+// Function bodies are lowered in parallel, one task per function. The module's
+// function array and symbol table are filled in before any body is lowered
+// and are only read afterwards, so each task only writes its own function.
+// Each task also reports into its own diagnostics, which are merged in source
+// order once every task is done.
+typedef struct {
+    IRModule* module;
+    SymbolTable* functions;
+    IRFunction* function;
+    int block;
+    Arena* scratch;
+    Diagnostics* diagnostics;
+} Lowerer;
+
+int lower_lookup_slot(Lowerer* lowerer, const char* name);
+int lower_emit(Lowerer* lowerer, IROpcode op, IRType type, int a, int b, int imm);
+int lower_call(Lowerer* lowerer, ASTNode* node);
+int lower_expr(Lowerer* lowerer, ASTNode* node);
+bool lower_stmt(Lowerer* lowerer, ASTNode* node);
+bool lower_fn_decl(Lowerer* lowerer, ASTNode* node);
+QuarkStatus lower_declare_fn(IRModule* module, SymbolTable* functions, ASTNode* node, Diagnostics* diagnostics);
+QuarkStatus lower_program(ASTNode* root, ThreadPool* pool, IRModule* module, Diagnostics* diagnostics);
+
+#endif
@@ -1,18 +1,60 @@
-#include "lexer.h"
-#include "parser.h"
+#include "quark.h"
 
 void print_usage() {
-    printf("USAGE: qkc <file_name>\n");
+    printf("USAGE: qkc [--emit-ir | --stream] [--time-passes] [--report-inlining] [-j <jobs>] <file_name>\n");
+}
+
+// Prints each declaration as it is parsed when streaming.
+QuarkStatus print_decl(void* user_data, ASTNode* decl) {
+    print_ast_node(user_data, decl);
+    return QUARK_OK;
+}
+
+void print_diagnostics(QuarkContext* context) {
+    for (size_t i = 0; i < quark_diagnostic_count(context); i++) {
+        const Diagnostic* diagnostic = quark_diagnostic_at(context, i);
+        printf("ERROR: %s\n", diagnostic->message ? diagnostic->message : quark_status_name(diagnostic->status));
+    }
 }
 
 int main(int argc, char** argv) {
-    if (argc < 2) {
+    const char* file_path = NULL;
+    bool emit_ir = false;
+    bool stream = false;
+
+    QuarkOptions options;
+    quark_options_init(&options);
+    options.passes.report_stream = stdout;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--emit-ir") == 0) {
+            emit_ir = true;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = true;
+        } else if (strcmp(argv[i], "--time-passes") == 0) {
+            options.passes.time_passes = true;
+        } else if (strcmp(argv[i], "--report-inlining") == 0) {
+            options.passes.report_inlining = true;
+        } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) < 1) {
+                printf("ERROR: %s expects a positive number of jobs\n", argv[i]);
+                exit(EXIT_FAILURE);
+            }
+            options.jobs = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            printf("ERROR: Unknown option -> %s\n", argv[i]);
+            print_usage();
+            exit(EXIT_FAILURE);
+        } else {
+            file_path = argv[i];
+        }
+    }
+
+    if (file_path == NULL) {
         print_usage();
         exit(EXIT_SUCCESS);
     }
 
-    const char* file_path = argv[1];
-
     FILE* file = fopen(file_path, "r");
     if (file == NULL) {
         printf("ERROR: Could not open file -> %s\n", file_path); 
@@ -22,7 +64,12 @@ int main(int argc, char** argv) {
     const size_t file_size = ftell(file);
     rewind(file);
 
-    char file_content[file_size + 1];
+    // Large generated files would overflow the stack, keep them on the heap.
+    char* file_content = malloc(file_size + 1);
+    if (!file_content) {
+        printf("ERROR: Could not allocate memory for file -> %s\n", file_path);
+        exit(EXIT_FAILURE);
+    }
 
     fread(file_content, file_size, 1, file);
     file_content[file_size] = '\0';
@@ -30,18 +77,31 @@ int main(int argc, char** argv) {
 
     printf("File (%s) size in bytes: %li\n", file_path, file_size);
 
-    Lexer lexer;
-    lexer_init(&lexer, file_content);
+    QuarkContext* context = quark_context_create(&options);
+    if (!context) {
+        printf("ERROR: Could not create compiler context\n");
+        free(file_content);
+        exit(EXIT_FAILURE);
+    }
 
-    TokenArray* tokens = lex_src(&lexer);
-    //print_token_array(tokens);
+    QuarkStatus status;
+    if (stream) {
+        // Only parses, but never holds more than one declaration in memory.
+        status = quark_parse_stream(context, file_content, print_decl, stdout);
+    } else {
+        status = quark_compile(context, file_content);
+    }
 
-    Parser* parser = parser_init(tokens);
-    ASTNode* ast = parse_token_array(parser);
-    print_ast(ast);
+    if (!emit_ir && quark_context_ast(context)) {
+        print_ast(stdout, quark_context_ast(context));
+    }
+    if (emit_ir && quark_context_module(context)) {
+        print_ir_module(stdout, quark_context_module(context));
+    }
+    print_diagnostics(context);
 
-    free_token_array(tokens);
-    free(ast);
+    quark_context_destroy(context);
+    free(file_content);
 
-    return 0;
+    return status == QUARK_OK ? EXIT_SUCCESS : EXIT_FAILURE;
 }
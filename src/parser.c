@@ -2,53 +2,188 @@
 #include "ast.h"
 
 // ----- PARSER -----
-Parser* parser_init(TokenArray* token_array) {
-    Parser* new_parser = malloc(sizeof(Parser));
-    if (!new_parser) {
-        printf("Failed to allocate memory for new parser\n");
-        exit(EXIT_FAILURE);
+void parser_init(Parser* parser, TokenArray* token_array, Arena* arena, Diagnostics* diagnostics) {
+    parser->token_array = token_array;
+    parser->position = 0;
+    parser->current_token = parser->token_array->tokens[parser->position];
+    parser->lexer = NULL;
+    parser->arena = arena;
+    parser->diagnostics = diagnostics;
+    parser->status = QUARK_OK;
+}
+
+// Tokens and nodes both go into the lexer's arena, which parse_stream resets
+// between top level declarations.
+void parser_init_stream(Parser* parser, Lexer* lexer, TokenArray* window, Diagnostics* diagnostics) {
+    token_array_clear(window);
+
+    parser->token_array = window;
+    parser->current_token = NULL;
+    parser->position = 0;
+    parser->lexer = lexer;
+    parser->arena = lexer->arena;
+    parser->diagnostics = diagnostics;
+    parser->status = lexer->status;
+
+    if (parser_fill(parser, 0)) {
+        parser->current_token = window->tokens[0];
     }
+}
 
-    new_parser->token_array = token_array;
-    new_parser->position = 0;
-    new_parser->current_token = new_parser->token_array->tokens[new_parser->position];
+// Lexes until position is inside the token array. Returns false when it lies
+// past the EOF token or lexing failed. Without a lexer every token is already
+// in the array.
+bool parser_fill(Parser* parser, size_t position) {
+    TokenArray* window = parser->token_array;
+    while (parser->lexer && position >= window->length && parser->status == QUARK_OK) {
+        if (window->length > 0 && window->tokens[window->length - 1]->type == TOK_EOF) { break; }
+
+        Token* token = lexer_next_token(parser->lexer);
+        if (!token) {
+            parser->status = parser->lexer->status;
+            break;
+        }
 
-    return new_parser;
+        if (!add_token(window, token)) {
+            parser->status = diagnostics_report(parser->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to reallocate token array tokens");
+        }
+    }
+
+    return position < window->length;
 }
 
-void parser_advance(Parser* parser, TokenType expected_type) {
-    if (parser->position + 1 >= parser->token_array->length) {
-        printf("Parser has reached the final token\n");
-        return;
+// Returns false once the parser has failed, either now or earlier.
+bool parser_advance(Parser* parser, TokenType expected_type) {
+    if (parser->status != QUARK_OK) { return false; }
+
+    size_t step = expected_type == TOK_ARROW ? 2 : 1;
+    bool filled = parser_fill(parser, parser->position + step);
+    if (parser->status != QUARK_OK) { return false; }
+
+    if (!filled) {
+        if (expected_type != TOK_NONE) {
+            parser->status = diagnostics_report(parser->diagnostics, QUARK_ERROR_SYNTAX, "Expected %s but reached the end of file", token_type_name(expected_type));
+            return false;
+        }
+        return true;
     }
 
     Token* next_token = parser->token_array->tokens[parser->position + 1];
     if ((next_token->type != expected_type) && expected_type != TOK_NONE) {
-        printf("Token %s, does not have type %d\n", next_token->value, expected_type);
-        exit(EXIT_FAILURE);
+        // Punctuation names already spell the token, only words need their value.
+        bool has_word = next_token->type == TOK_ID || next_token->type == TOK_INT || next_token->type == TOK_KEYWORD;
+        parser->status = diagnostics_report(parser->diagnostics, QUARK_ERROR_SYNTAX, "Expected %s but found %s%s%s%s", token_type_name(expected_type), token_type_name(next_token->type),
+            has_word ? " '" : "", has_word ? next_token->value : "", has_word ? "'" : "");
+        return false;
     }
 
-    if (parser->position >= parser->token_array->length) {
-        printf("Parser has reached the end of the token list\n");
-        return;
-    }
+    parser->position += step;
+    parser->current_token = parser->token_array->tokens[parser->position];
 
-    if (expected_type == TOK_ARROW) {
-        parser->position += 2;
-        parser->current_token = parser->token_array->tokens[parser->position];
-        return;
+    return true;
+}
+
+// Anything outside the token array reads as the final EOF token.
+Token* parser_peek(Parser* parser, int offset) {
+    long position = (long)parser->position + offset;
+    if (position > 0) { parser_fill(parser, (size_t)position); }
+    if (position < 0 || position >= (long)parser->token_array->length) {
+        return parser->token_array->tokens[parser->token_array->length - 1];
     }
 
-    parser->position++;
-    parser->current_token = parser->token_array->tokens[parser->position];
+    return parser->token_array->tokens[position];
 }
 
-Token* parser_peek(Parser* parser, int offset) {
-    return parser->token_array->tokens[parser->position + offset];
+// Turns a NULL from an ast create function into an error. Bad operands were
+// already reported by whoever parsed them, so NULL here means out of memory.
+ASTNode* parser_check(Parser* parser, ASTNode* node) {
+    if (!node && parser->status == QUARK_OK) {
+        parser->status = diagnostics_report(parser->diagnostics, QUARK_ERROR_OUT_OF_MEMORY, "Failed to allocate memory for ast node");
+    }
+
+    return node;
 }
 
 int parser_has_tokens(Parser* parser) {
-    return (parser->position < parser->token_array->length && parser->current_token->type != TOK_EOF);
+    return (parser->status == QUARK_OK && parser->position < parser->token_array->length && parser->current_token->type != TOK_EOF);
+}
+
+// Expression parsers start on the first token of the expression and leave the
+// parser on its last token, matching how statements leave it on their ';'.
+ASTNode* parse_call(Parser* parser) {
+    const char* name = parser->current_token->value;
+    if (!parser_advance(parser, TOK_LPAREN)) { return NULL; }     // (
+
+    ASTNode* args = NULL;
+    ASTNode* last_arg = NULL;
+    int arg_count = 0;
+
+    while (parser_peek(parser, 1)->type != TOK_RPAREN) {
+        if (arg_count > 0) {
+            if (!parser_advance(parser, TOK_COMMA)) { return NULL; }
+        }
+        if (!parser_advance(parser, TOK_NONE)) { return NULL; }
+
+        ASTNode* arg = parse_expr(parser);
+        if (!arg) { return NULL; }
+
+        if (last_arg) { last_arg->next = arg; } else { args = arg; }
+        last_arg = arg;
+        arg_count++;
+    }
+
+    if (!parser_advance(parser, TOK_RPAREN)) { return NULL; }     // )
+
+    return parser_check(parser, ast_create_fn_call(parser->arena, name, args, arg_count));
+}
+
+ASTNode* parse_primary(Parser* parser) {
+    if (parser->status != QUARK_OK) { return NULL; }
+
+    switch (parser->current_token->type) {
+        case TOK_INT:
+            return parser_check(parser, ast_create_literal(parser->arena, "i32", atoi(parser->current_token->value)));
+        case TOK_ID:
+            if (parser_peek(parser, 1)->type == TOK_LPAREN) {
+                return parse_call(parser);
+            }
+            return parser_check(parser, ast_create_identifier(parser->arena, parser->current_token->value));
+        default:
+            parser->status = diagnostics_report(parser->diagnostics, QUARK_ERROR_SYNTAX, "Invalid token found at the start of expression -> %s", parser->current_token->value ? parser->current_token->value : token_type_name(parser->current_token->type));
+            return NULL;
+    }
+}
+
+ASTNode* parse_term(Parser* parser) {
+    ASTNode* lhs = parse_primary(parser);
+
+    while (lhs && parser_peek(parser, 1)->type == TOK_STAR) {
+        if (!parser_advance(parser, TOK_STAR) || !parser_advance(parser, TOK_NONE)) { return NULL; }
+
+        ASTNode* rhs = parse_primary(parser);
+        if (!rhs) { return NULL; }
+
+        lhs = parser_check(parser, ast_create_binary_op(parser->arena, '*', lhs, rhs));
+    }
+
+    return lhs;
+}
+
+ASTNode* parse_expr(Parser* parser) {
+    ASTNode* lhs = parse_term(parser);
+
+    while (lhs && (parser_peek(parser, 1)->type == TOK_PLUS || parser_peek(parser, 1)->type == TOK_DASH)) {
+        if (!parser_advance(parser, TOK_NONE)) { return NULL; }
+        char op = parser->current_token->value[0];
+        if (!parser_advance(parser, TOK_NONE)) { return NULL; }
+
+        ASTNode* rhs = parse_term(parser);
+        if (!rhs) { return NULL; }
+
+        lhs = parser_check(parser, ast_create_binary_op(parser->arena, op, lhs, rhs));
+    }
+
+    return lhs;
 }
 
 ASTNode* parse_id(Parser* parser) {
@@ -57,77 +192,115 @@ ASTNode* parse_id(Parser* parser) {
         //  |-- Check if in a function scope (valid return).
         //  |-- Then see if the return value is of same return type. 'return;' is of return type NONE
         //  |-- Then grab return value and use it.
-        parser_advance(parser, TOK_INT);
-        const char* return_value = parser->current_token->value;
+        if (!parser_advance(parser, TOK_NONE)) { return NULL; }
+
+        ASTNode* value = parse_expr(parser);
+        if (!value) { return NULL; }
 
-        ASTNode* return_stmt_node = ast_create_return_stmt(ast_create_literal("i32", atoi(return_value)));
+        ASTNode* return_stmt_node = parser_check(parser, ast_create_return_stmt(parser->arena, value));
 
-        parser_advance(parser, TOK_SEMI);
+        if (!parser_advance(parser, TOK_SEMI)) { return NULL; }
 
         return return_stmt_node;
     }
 
+    if (parser_peek(parser, 1)->type == TOK_LPAREN) {
+        ASTNode* call_node = parse_call(parser);
+        if (!parser_advance(parser, TOK_SEMI)) { return NULL; }
+
+        return call_node;
+    }
+
     parser_advance(parser, 0);
     return NULL;
 }
 
 ASTNode* parse_decl(Parser* parser) {
-    if (strcmp(parser_peek(parser, 1)->value, "fn") == 0) {
-        const char* func_name = parser_peek(parser, -1)->value; // main
+    Token* name_token = parser_peek(parser, -1);
+    if (name_token->type != TOK_ID) {
+        parser->status = diagnostics_report(parser->diagnostics, QUARK_ERROR_SYNTAX, "Expected a name before ':'");
+        return NULL;
+    }
+
+    if (parser_peek(parser, 1)->type == TOK_ID && strcmp(parser_peek(parser, 1)->value, "fn") == 0) {
+        const char* func_name = name_token->value; // main
+
+        if (!parser_advance(parser, TOK_ID)) { return NULL; }         // func
+        if (!parser_advance(parser, TOK_LPAREN)) { return NULL; }     // (
+
+        ASTNode* params = NULL;
+        ASTNode* last_param = NULL;
+        int param_count = 0;
+
+        while (parser_peek(parser, 1)->type != TOK_RPAREN) {
+            if (param_count > 0) {
+                if (!parser_advance(parser, TOK_COMMA)) { return NULL; }
+            }
 
-        parser_advance(parser, TOK_ID);         // func
-        parser_advance(parser, TOK_LPAREN);     // (
+            if (!parser_advance(parser, TOK_ID)) { return NULL; }     // name
+            const char* param_name = parser->current_token->value;
+            if (!parser_advance(parser, TOK_COLON)) { return NULL; }  // :
+            if (!parser_advance(parser, TOK_ID)) { return NULL; }     // type
 
-        // TODO: Parse parameters
+            ASTNode* param = parser_check(parser, ast_create_param(parser->arena, param_name, parser->current_token->value));
+            if (!param) { return NULL; }
 
-        parser_advance(parser, TOK_RPAREN);     // )
-        parser_advance(parser, TOK_ARROW);      // ->
+            if (last_param) { last_param->next = param; } else { params = param; }
+            last_param = param;
+            param_count++;
+        }
+
+        if (!parser_advance(parser, TOK_RPAREN)) { return NULL; }     // )
+        if (!parser_advance(parser, TOK_ARROW)) { return NULL; }      // ->
 
         const char* return_type = parser->current_token->value;
 
-        parser_advance(parser, TOK_LBRACE);      // {
+        if (!parser_advance(parser, TOK_LBRACE)) { return NULL; }      // {
 
         // ASTNode* body = parse_scope(parser);
-        ASTNode* body = ast_create_empty();
+        ASTNode* body = parser_check(parser, ast_create_empty(parser->arena));
+        if (!body) { return NULL; }
+
         parse_scope(parser, body);
+        if (parser->status != QUARK_OK) { return NULL; }
 
-        ASTNode* ast_func_node = ast_create_fn_decl(func_name, return_type, body);
+        ASTNode* ast_func_node = parser_check(parser, ast_create_fn_decl(parser->arena, func_name, params, param_count, return_type, body));
         return ast_func_node;
     }
 
-    const char* name = parser_peek(parser, -1)->value;
+    const char* name = name_token->value;
 
-    parser_advance(parser, TOK_ID);    // type
+    if (!parser_advance(parser, TOK_ID)) { return NULL; }    // type
     const char* type = parser->current_token->value;
 
-    parser_advance(parser, TOK_EQUAL);      // =
+    if (!parser_advance(parser, TOK_EQUAL)) { return NULL; }      // =
 
-    // TODO: Make this work for any type
-    parser_advance(parser, TOK_INT);        // literal
-    const char* value = parser->current_token->value;
+    if (!parser_advance(parser, TOK_NONE)) { return NULL; }       // value
+    ASTNode* value = parse_expr(parser);
+    if (!value) { return NULL; }
 
-    parser_advance(parser, TOK_SEMI);
+    if (!parser_advance(parser, TOK_SEMI)) { return NULL; }
 
-    ASTNode* ast_var_node = ast_create_var_decl(name, type, ast_create_literal(type, atoi(value)));
+    ASTNode* ast_var_node = parser_check(parser, ast_create_var_decl(parser->arena, name, type, value));
     return ast_var_node;
 }
 
 void parse_scope(Parser* parser, ASTNode* body) {
     if (parser->current_token->type != TOK_LBRACE) {
-        printf("Invalid token found at the start of scope -> %s\n", parser->current_token->value);
-        exit(EXIT_FAILURE);
+        parser->status = diagnostics_report(parser->diagnostics, QUARK_ERROR_SYNTAX, "Invalid token found at the start of scope -> %s", parser->current_token->value ? parser->current_token->value : token_type_name(parser->current_token->type));
+        return;
     }
 
+    // Append after the last node parsed so far instead of walking the whole
+    // list for every statement.
+    ASTNode* last_node = body;
     while (parser_has_tokens(parser) && (parser->current_token->type != TOK_RBRACE)) {
-        parse_tokens(parser, body);
+        parse_tokens(parser, last_node);
+        while (last_node->next) { last_node = last_node->next; }
     }
 }
 
 void parse_tokens(Parser* parser, ASTNode* root) {
-    if (!root) {
-        printf("Current token -> %s\n", parser->current_token->value);
-    }
-
     switch (parser->current_token->type) {
         case TOK_ID: {
             ASTNode* new_node = parse_id(parser);
@@ -137,7 +310,10 @@ void parse_tokens(Parser* parser, ASTNode* root) {
             break;
         }
         case TOK_COLON: {
-            ast_append_node(&root, parse_decl(parser));
+            ASTNode* new_node = parse_decl(parser);
+            if (!new_node) break;
+
+            ast_append_node(&root, new_node);
             break;
         }
         default:
@@ -147,10 +323,52 @@ void parse_tokens(Parser* parser, ASTNode* root) {
 }
 
 
+// Returns NULL when parsing failed, the reason is in the parser's diagnostics.
 ASTNode* parse_token_array(Parser* parser) {
-    ASTNode* root = ast_init();
+    ASTNode* root = parser_check(parser, ast_init(parser->arena));
+    if (!root) { return NULL; }
+
+    ASTNode* last_node = root->value.program.functions;
     while (parser_has_tokens(parser)) {
-        parse_tokens(parser, root->value.program.functions);
+        parse_tokens(parser, last_node);
+        while (last_node->next) { last_node = last_node->next; }
     }
-    return root;
+
+    return parser->status == QUARK_OK ? root : NULL;
+}
+
+// Parses one top level declaration at a time and hands it to callback. Top
+// level declarations end on their '}' or ';' and nothing looks past that, so
+// once the callback returns every token and node in the arena belongs to
+// something already handed out. The arena and the token window are then
+// recycled, keeping memory bound by the largest declaration instead of the
+// whole file.
+QuarkStatus parse_stream(Parser* parser, ParseDeclCallback callback, void* user_data) {
+    while (parser_has_tokens(parser)) {
+        // parse_tokens copies the first node appended to an empty root into
+        // the root itself, so decl ends up holding the declaration.
+        ASTNode decl = { .type = AST_NONE, .next = NULL };
+        parse_tokens(parser, &decl);
+        if (parser->status != QUARK_OK) { break; }
+        if (decl.type == AST_NONE) { continue; }
+
+        QuarkStatus status = callback(user_data, &decl);
+        if (status != QUARK_OK) {
+            parser->status = status;
+            break;
+        }
+
+        // Anything lexed ahead of the current token would be lost, so keep
+        // the window around until the next declaration in that case.
+        if (parser->position + 1 != parser->token_array->length) { continue; }
+
+        token_array_clear(parser->token_array);
+        arena_reset(parser->arena);
+        parser->position = 0;
+        if (!parser_fill(parser, 0)) { break; }
+
+        parser->current_token = parser->token_array->tokens[0];
+    }
+
+    return parser->status;
 }
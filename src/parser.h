@@ -4,22 +4,45 @@
 #include "ast.h"
 
 // ----- PARSER -----
+// The first error stops the parse: it is reported to diagnostics, kept in
+// status and every parse function returns NULL from then on.
 typedef struct Parser {
     TokenArray* token_array;
     Token* current_token;
     size_t position;
+    // Only set when streaming. The token array is then a window that is
+    // filled from the lexer as the parser reaches the end of it.
+    Lexer* lexer;
+    Arena* arena;
+    Diagnostics* diagnostics;
+    QuarkStatus status;
 } Parser;
 
-Parser* parser_init(TokenArray* token_array);
-void parser_advance(Parser* parser, TokenType expected_type);
+void parser_init(Parser* parser, TokenArray* token_array, Arena* arena, Diagnostics* diagnostics);
+void parser_init_stream(Parser* parser, Lexer* lexer, TokenArray* window, Diagnostics* diagnostics);
+bool parser_fill(Parser* parser, size_t position);
+bool parser_advance(Parser* parser, TokenType expected_type);
 Token* parser_peek(Parser* parser, int offset);
+ASTNode* parser_check(Parser* parser, ASTNode* node);
 
 int parser_has_tokens(Parser* parser);
 
+ASTNode* parse_call(Parser* parser);
+ASTNode* parse_primary(Parser* parser);
+ASTNode* parse_term(Parser* parser);
+ASTNode* parse_expr(Parser* parser);
 ASTNode* parse_id(Parser* parser);
 ASTNode* parse_decl(Parser* parser);
 void parse_scope(Parser* parser, ASTNode* body);
 void parse_tokens(Parser* parser, ASTNode* root);
 ASTNode* parse_token_array(Parser* parser);
 
+// Receives each top level declaration as soon as it is parsed. The node and
+// everything it points to is recycled once the callback returns, so anything
+// that has to outlive it must be copied out. Returning anything other than
+// QUARK_OK stops the parse with that status.
+typedef QuarkStatus (*ParseDeclCallback)(void* user_data, ASTNode* decl);
+
+QuarkStatus parse_stream(Parser* parser, ParseDeclCallback callback, void* user_data);
+
 #endif
@@ -0,0 +1,563 @@
+#include "passes.h"
+
+// ----- PASSES -----
+// Forwards stored values to later loads of the same slot, rewrites uses of the
+// forwarded registers and folds arithmetic whose operands are both constant.
+// Slot values are only trusted within the block that stored them.
+QuarkStatus pass_const_prop(IRModule* module, IRFunction* function, PassOptions* options, Arena* scratch, bool* changed) {
+    int* alias = arena_alloc(scratch, function->reg_count * sizeof(int));
+    bool* is_const = arena_calloc(scratch, function->reg_count, sizeof(bool));
+    int* const_value = arena_alloc(scratch, function->reg_count * sizeof(int));
+    int* slot_value = arena_alloc(scratch, function->slot_count * sizeof(int));
+    size_t* slot_block = arena_alloc(scratch, function->slot_count * sizeof(size_t));
+    if (!alias || !is_const || !const_value || !slot_value || !slot_block) { return QUARK_ERROR_OUT_OF_MEMORY; }
+
+    for (int i = 0; i < function->reg_count; i++) { alias[i] = i; }
+    for (int i = 0; i < function->slot_count; i++) { slot_block[i] = (size_t)-1; }
+
+    for (size_t i = 0; i < function->block_count; i++) {
+        IRBlock* block = &function->blocks[i];
+        for (size_t j = 0; j < block->length; j++) {
+            IRInstr* instr = &block->instrs[j];
+            if (instr->a != IR_NO_REG) { instr->a = alias[instr->a]; }
+            if (instr->b != IR_NO_REG) { instr->b = alias[instr->b]; }
+
+            switch (instr->op) {
+                case IR_CONST:
+                    is_const[instr->dest] = true;
+                    const_value[instr->dest] = instr->imm;
+                    break;
+                case IR_ADD:
+                case IR_SUB:
+                case IR_MUL: {
+                    if (!is_const[instr->a] || !is_const[instr->b]) { break; }
+
+                    // Wrap like the target would instead of overflowing.
+                    unsigned int lhs = (unsigned int)const_value[instr->a];
+                    unsigned int rhs = (unsigned int)const_value[instr->b];
+                    unsigned int result = instr->op == IR_ADD ? lhs + rhs : instr->op == IR_SUB ? lhs - rhs : lhs * rhs;
+
+                    instr->op = IR_CONST;
+                    instr->imm = (int)result;
+                    instr->a = IR_NO_REG;
+                    instr->b = IR_NO_REG;
+                    is_const[instr->dest] = true;
+                    const_value[instr->dest] = instr->imm;
+                    *changed = true;
+                    break;
+                }
+                case IR_LOAD:
+                    if (slot_block[instr->imm] != i) { break; }
+
+                    alias[instr->dest] = slot_value[instr->imm];
+                    instr->op = IR_NOP;
+                    *changed = true;
+                    break;
+                case IR_STORE:
+                    slot_value[instr->imm] = instr->a;
+                    slot_block[instr->imm] = i;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        ir_block_compact(block);
+    }
+
+    return QUARK_OK;
+}
+
+// Removes stores to slots that are never loaded, and stores that are
+// overwritten later in the same block before anything loads them.
+QuarkStatus pass_dead_store_elim(IRModule* module, IRFunction* function, PassOptions* options, Arena* scratch, bool* changed) {
+    int* load_count = arena_calloc(scratch, function->slot_count, sizeof(int));
+    IRInstr** last_store = arena_alloc(scratch, function->slot_count * sizeof(IRInstr*));
+    size_t* last_store_block = arena_alloc(scratch, function->slot_count * sizeof(size_t));
+    if (!load_count || !last_store || !last_store_block) { return QUARK_ERROR_OUT_OF_MEMORY; }
+
+    for (size_t i = 0; i < function->block_count; i++) {
+        IRBlock* block = &function->blocks[i];
+        for (size_t j = 0; j < block->length; j++) {
+            if (block->instrs[j].op == IR_LOAD) { load_count[block->instrs[j].imm]++; }
+        }
+    }
+
+    for (int k = 0; k < function->slot_count; k++) { last_store_block[k] = (size_t)-1; }
+
+    for (size_t i = 0; i < function->block_count; i++) {
+        IRBlock* block = &function->blocks[i];
+        for (size_t j = 0; j < block->length; j++) {
+            IRInstr* instr = &block->instrs[j];
+            if (instr->op == IR_LOAD) {
+                last_store[instr->imm] = NULL;
+            } else if (instr->op == IR_STORE) {
+                if (load_count[instr->imm] == 0) {
+                    instr->op = IR_NOP;
+                    *changed = true;
+                    continue;
+                }
+
+                if (last_store_block[instr->imm] == i && last_store[instr->imm]) {
+                    last_store[instr->imm]->op = IR_NOP;
+                    *changed = true;
+                }
+                last_store[instr->imm] = instr;
+                last_store_block[instr->imm] = i;
+            }
+        }
+
+        ir_block_compact(block);
+    }
+
+    return QUARK_OK;
+}
+
+// Removes pure instructions whose result is never used. Removing one can make
+// its operands dead too, so those are pushed onto a worklist.
+QuarkStatus pass_dead_code_elim(IRModule* module, IRFunction* function, PassOptions* options, Arena* scratch, bool* changed) {
+    int* use_count = arena_calloc(scratch, function->reg_count, sizeof(int));
+    IRInstr** def = arena_calloc(scratch, function->reg_count, sizeof(IRInstr*));
+    int* worklist = arena_alloc(scratch, function->reg_count * sizeof(int));
+    if (!use_count || !def || !worklist) { return QUARK_ERROR_OUT_OF_MEMORY; }
+
+    for (size_t i = 0; i < function->block_count; i++) {
+        IRBlock* block = &function->blocks[i];
+        for (size_t j = 0; j < block->length; j++) {
+            IRInstr* instr = &block->instrs[j];
+            if (instr->dest != IR_NO_REG) { def[instr->dest] = instr; }
+            if (instr->a != IR_NO_REG) { use_count[instr->a]++; }
+            if (instr->b != IR_NO_REG) { use_count[instr->b]++; }
+        }
+    }
+
+    int worklist_length = 0;
+    for (int reg = 0; reg < function->reg_count; reg++) {
+        if (def[reg] && use_count[reg] == 0) { worklist[worklist_length++] = reg; }
+    }
+
+    while (worklist_length > 0) {
+        IRInstr* instr = def[worklist[--worklist_length]];
+        if (!ir_instr_is_pure(instr)) { continue; }
+
+        int operands[2] = { instr->a, instr->b };
+        for (int k = 0; k < 2; k++) {
+            if (operands[k] == IR_NO_REG) { continue; }
+
+            use_count[operands[k]]--;
+            if (use_count[operands[k]] == 0 && def[operands[k]]) {
+                worklist[worklist_length++] = operands[k];
+            }
+        }
+
+        instr->op = IR_NOP;
+        *changed = true;
+    }
+
+    for (size_t i = 0; i < function->block_count; i++) {
+        ir_block_compact(&function->blocks[i]);
+    }
+
+    return QUARK_OK;
+}
+
+// Removes every function that cannot be reached from main. A module without a
+// main is left untouched since any function could be an entry point.
+QuarkStatus pass_global_dce(IRModule* module, PassOptions* options, bool* changed) {
+    int main_index = ir_module_find_function(module, "main");
+    if (main_index < 0) { return QUARK_OK; }
+
+    // Doubles as the remap for ir_module_remove_functions, -1 is unreachable.
+    int* reachable = malloc(module->length * sizeof(int));
+    int* worklist = malloc(module->length * sizeof(int));
+    if (!reachable || !worklist) {
+        free(reachable);
+        free(worklist);
+        return QUARK_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < module->length; i++) { reachable[i] = -1; }
+
+    int worklist_length = 0;
+    reachable[main_index] = 1;
+    worklist[worklist_length++] = main_index;
+
+    while (worklist_length > 0) {
+        IRFunction* function = &module->functions[worklist[--worklist_length]];
+        for (size_t i = 0; i < function->block_count; i++) {
+            IRBlock* block = &function->blocks[i];
+            for (size_t j = 0; j < block->length; j++) {
+                IRInstr* instr = &block->instrs[j];
+                if (instr->op != IR_CALL || reachable[instr->imm] >= 0) { continue; }
+
+                reachable[instr->imm] = 1;
+                worklist[worklist_length++] = instr->imm;
+            }
+        }
+    }
+
+    if (ir_module_remove_functions(module, reachable) > 0) { *changed = true; }
+
+    free(reachable);
+    free(worklist);
+
+    return QUARK_OK;
+}
+
+// Cost of inlining a function, or -1 with a reason when it can never be
+// inlined. Only single block leaf functions are candidates and their cost is
+// the number of instructions that would be copied into the caller.
+static int inline_cost(IRFunction* function, const char** reason) {
+    if (function->block_count != 1) {
+        *reason = "more than one block";
+        return -1;
+    }
+
+    IRBlock* block = &function->blocks[0];
+    if (block->length == 0 || block->instrs[block->length - 1].op != IR_RET) {
+        *reason = "does not end in a return";
+        return -1;
+    }
+
+    int cost = 0;
+    for (size_t i = 0; i < block->length; i++) {
+        switch (block->instrs[i].op) {
+            case IR_CALL:
+                *reason = "not a leaf";
+                return -1;
+            case IR_PARAM:
+            case IR_RET:
+                break;
+            default:
+                cost++;
+        }
+    }
+
+    return cost;
+}
+
+// Copies the callee body onto the end of out. Params become the argument
+// registers and the call result becomes whatever the callee returned.
+static bool inline_body(IRFunction* caller, IRFunction* callee, IRBlock* out, int* args, int call_dest, int* alias, int* reg_map) {
+    int slot_base = caller->slot_count;
+    for (int i = 0; i < callee->slot_count; i++) {
+        if (ir_function_add_slot(caller, callee->slots[i].name, callee->slots[i].type) < 0) { return false; }
+    }
+
+    IRBlock* body = &callee->blocks[0];
+    for (size_t i = 0; i < body->length; i++) {
+        IRInstr instr = body->instrs[i];
+
+        if (instr.op == IR_PARAM) {
+            reg_map[instr.dest] = args[instr.imm];
+            continue;
+        }
+        if (instr.op == IR_RET) {
+            if (call_dest != IR_NO_REG) { alias[call_dest] = reg_map[instr.a]; }
+            continue;
+        }
+
+        if (instr.a != IR_NO_REG) { instr.a = reg_map[instr.a]; }
+        if (instr.b != IR_NO_REG) { instr.b = reg_map[instr.b]; }
+        if (instr.dest != IR_NO_REG) {
+            int dest = ir_function_new_reg(caller, callee->reg_types[instr.dest]);
+            if (dest < 0) { return false; }
+            reg_map[instr.dest] = dest;
+            instr.dest = dest;
+        }
+        if (instr.op == IR_LOAD || instr.op == IR_STORE) { instr.imm += slot_base; }
+
+        if (!ir_block_append(out, instr)) { return false; }
+    }
+
+    return true;
+}
+
+// Inlines small leaf callees into every call site, visiting callees before
+// their callers so a helper that only calls helpers becomes a leaf itself.
+// Functions that had callers before and have none left are removed.
+QuarkStatus pass_inline(IRModule* module, PassOptions* options, bool* changed) {
+    if (module->length == 0) { return QUARK_OK; }
+
+    FILE* report = options->report_inlining ? options->report_stream : NULL;
+    QuarkStatus status = QUARK_OK;
+
+    CallGraph* graph = callgraph_build(module);
+    int* order = graph ? callgraph_bottom_up_order(graph) : NULL;
+    int* costs = malloc(module->length * sizeof(int));
+    const char** reasons = calloc(module->length, sizeof(const char*));
+    bool* cost_known = calloc(module->length, sizeof(bool));
+    int reg_map_capacity = 16;
+    int* reg_map = malloc(reg_map_capacity * sizeof(int));
+    int* alias = NULL;
+    // Doubles as the remap for ir_module_remove_functions, -1 is removed.
+    int* keep = malloc(module->length * sizeof(int));
+    CallGraph* inlined_graph = NULL;
+
+    if (!graph || !order || !costs || !reasons || !cost_known || !reg_map || !keep) {
+        status = QUARK_ERROR_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    if (report) {
+        fprintf(report, "Call graph:\n");
+        print_callgraph(report, graph, module);
+    }
+
+    for (size_t i = 0; i < module->length; i++) {
+        IRFunction* caller = &module->functions[order[i]];
+        if (graph->nodes[order[i]].length == 0) { continue; }
+
+        int original_regs = caller->reg_count;
+        alias = malloc((original_regs > 0 ? original_regs : 1) * sizeof(int));
+        if (!alias) {
+            status = QUARK_ERROR_OUT_OF_MEMORY;
+            goto cleanup;
+        }
+        for (int reg = 0; reg < original_regs; reg++) { alias[reg] = reg; }
+
+        for (size_t j = 0; j < caller->block_count; j++) {
+            IRBlock out = { NULL, 0, 0 };
+
+            for (size_t k = 0; k < caller->blocks[j].length; k++) {
+                IRInstr instr = caller->blocks[j].instrs[k];
+                if (instr.a != IR_NO_REG && instr.a < original_regs) { instr.a = alias[instr.a]; }
+                if (instr.b != IR_NO_REG && instr.b < original_regs) { instr.b = alias[instr.b]; }
+
+                if (instr.op != IR_CALL) {
+                    if (!ir_block_append(&out, instr)) { status = QUARK_ERROR_OUT_OF_MEMORY; }
+                    if (status != QUARK_OK) { break; }
+                    continue;
+                }
+
+                IRFunction* callee = &module->functions[instr.imm];
+                if (!cost_known[instr.imm]) {
+                    costs[instr.imm] = inline_cost(callee, &reasons[instr.imm]);
+                    cost_known[instr.imm] = true;
+                }
+
+                int cost = costs[instr.imm];
+                if (cost < 0 || cost > options->inline_threshold) {
+                    if (report) {
+                        if (cost < 0) {
+                            fprintf(report, "Skip %s into %s: %s\n", callee->name, caller->name, reasons[instr.imm]);
+                        } else {
+                            fprintf(report, "Skip %s into %s: cost %d exceeds threshold %d\n", callee->name, caller->name, cost, options->inline_threshold);
+                        }
+                    }
+                    if (!ir_block_append(&out, instr)) {
+                        status = QUARK_ERROR_OUT_OF_MEMORY;
+                        break;
+                    }
+                    continue;
+                }
+
+                // Callees may have grown from inlining into them earlier on.
+                if (callee->reg_count > reg_map_capacity) {
+                    int* grown = realloc(reg_map, callee->reg_count * sizeof(int));
+                    if (!grown) {
+                        status = QUARK_ERROR_OUT_OF_MEMORY;
+                        break;
+                    }
+                    reg_map = grown;
+                    reg_map_capacity = callee->reg_count;
+                }
+
+                // The args sit directly before the call, take them back off.
+                out.length -= callee->param_count;
+                int args[callee->param_count > 0 ? callee->param_count : 1];
+                for (int p = 0; p < callee->param_count; p++) {
+                    args[out.instrs[out.length + p].imm] = out.instrs[out.length + p].a;
+                }
+
+                if (!inline_body(caller, callee, &out, args, instr.dest, alias, reg_map)) {
+                    status = QUARK_ERROR_OUT_OF_MEMORY;
+                    break;
+                }
+                *changed = true;
+
+                if (report) {
+                    fprintf(report, "Inline %s into %s: cost %d\n", callee->name, caller->name, cost);
+                }
+            }
+
+            // A half rebuilt block is dropped, the original stays freeable.
+            if (status != QUARK_OK) {
+                free(out.instrs);
+                goto cleanup;
+            }
+
+            free(caller->blocks[j].instrs);
+            caller->blocks[j] = out;
+        }
+
+        free(alias);
+        alias = NULL;
+    }
+
+    // Drop functions whose every call site was inlined.
+    inlined_graph = callgraph_build(module);
+    if (!inlined_graph) {
+        status = QUARK_ERROR_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < module->length; i++) {
+        bool kept = graph->nodes[i].caller_count == 0 || inlined_graph->nodes[i].caller_count > 0 || strcmp(module->functions[i].name, "main") == 0;
+        keep[i] = kept ? 1 : -1;
+        if (!kept && report) {
+            fprintf(report, "Remove %s: no callers left\n", module->functions[i].name);
+        }
+    }
+
+    if (ir_module_remove_functions(module, keep) > 0) { *changed = true; }
+
+cleanup:
+    free(alias);
+    free(keep);
+    free_callgraph(inlined_graph);
+    free(reg_map);
+    free(costs);
+    free(reasons);
+    free(cost_known);
+    free(order);
+    free_callgraph(graph);
+
+    return status;
+}
+
+// ----- PASS MANAGER -----
+PassManager* pass_manager_init(size_t capacity) {
+    PassManager* new_manager = malloc(sizeof(PassManager));
+    if (!new_manager) { return NULL; }
+
+    new_manager->capacity = capacity ? capacity : 1;
+    new_manager->length = 0;
+    new_manager->options.time_passes = false;
+    new_manager->options.report_inlining = false;
+    new_manager->options.inline_threshold = 16;
+    new_manager->options.report_stream = NULL;
+    new_manager->passes = calloc(new_manager->capacity, sizeof(IRPass));
+
+    if (!new_manager->passes) {
+        free(new_manager);
+        return NULL;
+    }
+
+    return new_manager;
+}
+
+bool pass_manager_add(PassManager* manager, IRPass pass) {
+    if (manager->length >= manager->capacity) {
+        IRPass* passes = realloc(manager->passes, manager->capacity * 2 * sizeof(IRPass));
+        if (!passes) { return false; }
+
+        manager->passes = passes;
+        manager->capacity = manager->capacity * 2;
+    }
+
+    manager->passes[manager->length] = pass;
+    manager->length++;
+
+    return true;
+}
+
+bool pass_manager_add_default_pipeline(PassManager* manager) {
+    IRPass pipeline[] = {
+        // Drop unreachable functions first so later passes never visit them.
+        { "global-dce", IR_PASS_MODULE, NULL, pass_global_dce },
+        { "const-prop", IR_PASS_FUNCTION, pass_const_prop, NULL },
+        { "dse", IR_PASS_FUNCTION, pass_dead_store_elim, NULL },
+        { "dce", IR_PASS_FUNCTION, pass_dead_code_elim, NULL },
+        // Inline once callees are already as small as they will get, then
+        // clean up what inlining exposed in the callers.
+        { "inline", IR_PASS_MODULE, NULL, pass_inline },
+        { "const-prop", IR_PASS_FUNCTION, pass_const_prop, NULL },
+        { "dse", IR_PASS_FUNCTION, pass_dead_store_elim, NULL },
+        { "dce", IR_PASS_FUNCTION, pass_dead_code_elim, NULL },
+    };
+
+    for (size_t i = 0; i < sizeof(pipeline) / sizeof(pipeline[0]); i++) {
+        if (!pass_manager_add(manager, pipeline[i])) { return false; }
+    }
+
+    return true;
+}
+
+static double elapsed_ms(struct timespec* start, struct timespec* end) {
+    return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
+typedef struct {
+    IRPass* pass;
+    IRModule* module;
+    PassOptions* options;
+    atomic_bool changed;
+    // First failure wins, the other tasks still run to completion.
+    atomic_int status;
+} FunctionPassJob;
+
+static void run_function_pass_task(void* context, size_t index, Arena* scratch) {
+    FunctionPassJob* job = context;
+    bool changed = false;
+
+    QuarkStatus status = job->pass->run_function(job->module, &job->module->functions[index], job->options, scratch, &changed);
+    if (changed) { atomic_store(&job->changed, true); }
+    if (status != QUARK_OK) {
+        int expected = QUARK_OK;
+        atomic_compare_exchange_strong(&job->status, &expected, (int)status);
+    }
+}
+
+// Module passes run on the calling thread. Function passes only touch the
+// function they are given, so each function is its own task on the pool.
+// Stops at the first pass that fails and reports it to diagnostics.
+QuarkStatus pass_manager_run(PassManager* manager, IRModule* module, ThreadPool* pool, Diagnostics* diagnostics) {
+    FILE* report = manager->options.time_passes ? manager->options.report_stream : NULL;
+    double total_ms = 0.0;
+
+    for (size_t i = 0; i < manager->length; i++) {
+        IRPass* pass = &manager->passes[i];
+        size_t instrs_before = report ? ir_module_instr_count(module) : 0;
+        bool changed = false;
+        QuarkStatus status;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        if (pass->kind == IR_PASS_MODULE) {
+            status = pass->run_module(module, &manager->options, &changed);
+        } else {
+            FunctionPassJob job = { .pass = pass, .module = module, .options = &manager->options };
+            atomic_init(&job.changed, false);
+            atomic_init(&job.status, QUARK_OK);
+            thread_pool_run(pool, module->length, run_function_pass_task, &job);
+            status = (QuarkStatus)atomic_load(&job.status);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        if (status != QUARK_OK) {
+            return diagnostics_report(diagnostics, status, "Pass %s failed: %s", pass->name, quark_status_name(status));
+        }
+
+        if (report) {
+            double ms = elapsed_ms(&start, &end);
+            total_ms += ms;
+            fprintf(report, "Pass %-12s %10.3f ms, instrs %zu -> %zu\n", pass->name, ms, instrs_before, ir_module_instr_count(module));
+        }
+    }
+
+    if (report) {
+        fprintf(report, "Pass %-12s %10.3f ms\n", "total", total_ms);
+    }
+
+    return QUARK_OK;
+}
+
+void free_pass_manager(PassManager* manager) {
+    if (!manager) { return; }
+
+    free(manager->passes);
+    free(manager);
+}
@@ -0,0 +1,57 @@
+#ifndef Q_PASSES_H
+#define Q_PASSES_H
+#include <time.h>
+#include "ir.h"
+#include "callgraph.h"
+#include "threadpool.h"
+#include "diagnostics.h"
+
+// ----- PASSES -----
+typedef struct {
+    bool time_passes;
+    bool report_inlining;
+    // Largest callee, in instructions copied into the caller, that is inlined.
+    int inline_threshold;
+    // Timing and inlining reports are written here, nothing is written when
+    // it is NULL.
+    FILE* report_stream;
+} PassOptions;
+
+// Function passes see one function at a time, module passes see the whole
+// module. Every pass sets changed when it changed the IR and only fails when
+// it runs out of memory, which leaves the module freeable but not usable.
+// Function passes may run concurrently on different functions and must keep
+// any temporaries in the scratch arena they are given.
+typedef enum {
+    IR_PASS_FUNCTION = 0,
+    IR_PASS_MODULE,
+} IRPassKind;
+
+typedef struct {
+    const char* name;
+    IRPassKind kind;
+    QuarkStatus (*run_function)(IRModule* module, IRFunction* function, PassOptions* options, Arena* scratch, bool* changed);
+    QuarkStatus (*run_module)(IRModule* module, PassOptions* options, bool* changed);
+} IRPass;
+
+QuarkStatus pass_const_prop(IRModule* module, IRFunction* function, PassOptions* options, Arena* scratch, bool* changed);
+QuarkStatus pass_dead_store_elim(IRModule* module, IRFunction* function, PassOptions* options, Arena* scratch, bool* changed);
+QuarkStatus pass_dead_code_elim(IRModule* module, IRFunction* function, PassOptions* options, Arena* scratch, bool* changed);
+QuarkStatus pass_global_dce(IRModule* module, PassOptions* options, bool* changed);
+QuarkStatus pass_inline(IRModule* module, PassOptions* options, bool* changed);
+
+// ----- PASS MANAGER -----
+typedef struct {
+    IRPass* passes;
+    size_t length;
+    size_t capacity;
+    PassOptions options;
+} PassManager;
+
+PassManager* pass_manager_init(size_t capacity);
+bool pass_manager_add(PassManager* manager, IRPass pass);
+bool pass_manager_add_default_pipeline(PassManager* manager);
+QuarkStatus pass_manager_run(PassManager* manager, IRModule* module, ThreadPool* pool, Diagnostics* diagnostics);
+void free_pass_manager(PassManager* manager);
+
+#endif
@@ -0,0 +1,153 @@
+#include "quark.h"
+
+#define QUARK_ARENA_SIZE (256 * 1024)
+
+// ----- OPTIONS -----
+void quark_options_init(QuarkOptions* options) {
+    options->jobs = 0;
+    options->passes.time_passes = false;
+    options->passes.report_inlining = false;
+    options->passes.inline_threshold = 16;
+    options->passes.report_stream = NULL;
+}
+
+// ----- CONTEXT -----
+struct QuarkContext {
+    ThreadPool* pool;
+    PassManager* pass_manager;
+
+    // Tokens, token values and the AST, reset between compiles.
+    Arena* arena;
+    TokenArray* tokens;
+    IRModule* module;
+    Diagnostics diagnostics;
+
+    // Which results of the last compile are complete.
+    bool has_tokens;
+    ASTNode* ast;
+    bool has_module;
+};
+
+QuarkContext* quark_context_create(const QuarkOptions* options) {
+    QuarkOptions defaults;
+    if (!options) {
+        quark_options_init(&defaults);
+        options = &defaults;
+    }
+    if (options->jobs < 0) { return NULL; }
+
+    QuarkContext* new_context = calloc(1, sizeof(QuarkContext));
+    if (!new_context) { return NULL; }
+
+    diagnostics_init(&new_context->diagnostics);
+    new_context->pool = thread_pool_init(options->jobs ? options->jobs : thread_pool_default_size());
+    new_context->pass_manager = pass_manager_init(8);
+    new_context->arena = arena_init(QUARK_ARENA_SIZE);
+    new_context->tokens = token_array_init(64);
+    new_context->module = ir_module_init(16);
+
+    if (!new_context->pool || !new_context->pass_manager || !new_context->arena || !new_context->tokens || !new_context->module
+        || !pass_manager_add_default_pipeline(new_context->pass_manager)) {
+        quark_context_destroy(new_context);
+        return NULL;
+    }
+
+    new_context->pass_manager->options = options->passes;
+
+    return new_context;
+}
+
+// Drops the results of the last compile, keeping every allocation warm. The
+// module goes first since its function names point into the arena.
+void quark_context_reset(QuarkContext* context) {
+    ir_module_clear(context->module);
+    token_array_clear(context->tokens);
+    arena_reset(context->arena);
+    diagnostics_clear(&context->diagnostics);
+
+    context->has_tokens = false;
+    context->ast = NULL;
+    context->has_module = false;
+}
+
+void quark_context_destroy(QuarkContext* context) {
+    if (!context) { return; }
+
+    free_ir_module(context->module);
+    free_token_array(context->tokens);
+    free_arena(context->arena);
+    free_diagnostics(&context->diagnostics);
+    free_pass_manager(context->pass_manager);
+    free_thread_pool(context->pool);
+    free(context);
+}
+
+QuarkStatus quark_compile(QuarkContext* context, const char* src) {
+    if (!context) { return QUARK_ERROR_INVALID_ARGUMENT; }
+
+    quark_context_reset(context);
+
+    Lexer lexer;
+    QuarkStatus status = lexer_init(&lexer, src, context->arena, &context->diagnostics);
+    if (status == QUARK_OK) { status = lex_src(&lexer, context->tokens); }
+    if (status != QUARK_OK) { return status; }
+    context->has_tokens = true;
+
+    Parser parser;
+    parser_init(&parser, context->tokens, context->arena, &context->diagnostics);
+    context->ast = parse_token_array(&parser);
+    if (!context->ast) { return parser.status; }
+
+    status = lower_program(context->ast, context->pool, context->module, &context->diagnostics);
+    if (status == QUARK_OK) { status = pass_manager_run(context->pass_manager, context->module, context->pool, &context->diagnostics); }
+    if (status != QUARK_OK) { return status; }
+    context->has_module = true;
+
+    return QUARK_OK;
+}
+
+QuarkStatus quark_parse_stream(QuarkContext* context, const char* src, ParseDeclCallback callback, void* user_data) {
+    if (!context || !callback) { return QUARK_ERROR_INVALID_ARGUMENT; }
+
+    quark_context_reset(context);
+
+    Lexer lexer;
+    QuarkStatus status = lexer_init(&lexer, src, context->arena, &context->diagnostics);
+    if (status != QUARK_OK) { return status; }
+
+    Parser parser;
+    parser_init_stream(&parser, &lexer, context->tokens, &context->diagnostics);
+    status = parse_stream(&parser, callback, user_data);
+
+    // The window and arena only hold what is left of the last declaration.
+    token_array_clear(context->tokens);
+    arena_reset(context->arena);
+
+    return status;
+}
+
+TokenArray* quark_context_tokens(QuarkContext* context) {
+    return context->has_tokens ? context->tokens : NULL;
+}
+
+ASTNode* quark_context_ast(QuarkContext* context) {
+    return context->ast;
+}
+
+IRModule* quark_context_module(QuarkContext* context) {
+    return context->has_module ? context->module : NULL;
+}
+
+QuarkStatus quark_context_status(QuarkContext* context) {
+    return context->diagnostics.status;
+}
+
+size_t quark_diagnostic_count(QuarkContext* context) {
+    return context->diagnostics.length;
+}
+
+const Diagnostic* quark_diagnostic_at(QuarkContext* context, size_t index) {
+    if (index >= context->diagnostics.length) { return NULL; }
+
+    return &context->diagnostics.items[index];
+}
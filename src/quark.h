@@ -0,0 +1,55 @@
+#ifndef Q_QUARK_H
+#define Q_QUARK_H
+#include "lexer.h"
+#include "parser.h"
+#include "lower.h"
+#include "passes.h"
+
+// ----- OPTIONS -----
+typedef struct {
+    // Worker threads for lowering and function passes, 0 picks one per core.
+    int jobs;
+    PassOptions passes;
+} QuarkOptions;
+
+void quark_options_init(QuarkOptions* options);
+
+// ----- CONTEXT -----
+// Everything one compile needs: the thread pool, the pass pipeline and the
+// memory the tokens, AST and IR live in. Nothing is global, so independent
+// contexts can be used from different threads at the same time, but a single
+// context must only be used by one thread at a time.
+//
+// A context is meant to be reused. Each compile drops the results of the one
+// before it but keeps the arena chunks, token array, module and diagnostics
+// storage, so a warm context compiles without going back to malloc for most
+// of its memory.
+typedef struct QuarkContext QuarkContext;
+
+QuarkContext* quark_context_create(const QuarkOptions* options);
+void quark_context_reset(QuarkContext* context);
+void quark_context_destroy(QuarkContext* context);
+
+// Lexes, parses, lowers and optimizes src. src only has to stay alive for the
+// duration of the call. On failure the diagnostics say what went wrong and
+// whatever stages succeeded keep their results, e.g. the AST of a program
+// that parsed but failed to lower.
+QuarkStatus quark_compile(QuarkContext* context, const char* src);
+
+// Lexes and parses src one top level declaration at a time, handing each to
+// callback and recycling its memory once the callback returns, see
+// parse_stream. Nothing is lowered and no results are kept, so the context's
+// tokens, AST and module are all NULL afterwards.
+QuarkStatus quark_parse_stream(QuarkContext* context, const char* src, ParseDeclCallback callback, void* user_data);
+
+// Results of the last compile, valid until the next compile or reset. NULL
+// when the stage that produces them did not complete.
+TokenArray* quark_context_tokens(QuarkContext* context);
+ASTNode* quark_context_ast(QuarkContext* context);
+IRModule* quark_context_module(QuarkContext* context);
+
+QuarkStatus quark_context_status(QuarkContext* context);
+size_t quark_diagnostic_count(QuarkContext* context);
+const Diagnostic* quark_diagnostic_at(QuarkContext* context, size_t index);
+
+#endif
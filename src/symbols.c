@@ -0,0 +1,98 @@
+#include "symbols.h"
+
+// ----- SYMBOL TABLE -----
+uint32_t symbol_hash(const char* name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char* c = name; *c; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+SymbolTable* symbol_table_init(size_t capacity) {
+    SymbolTable* new_table = malloc(sizeof(SymbolTable));
+    if (!new_table) { return NULL; }
+
+    // Capacity must be a power of two so probing can mask instead of divide.
+    size_t rounded = 16;
+    while (rounded < capacity) { rounded *= 2; }
+
+    new_table->capacity = rounded;
+    new_table->length = 0;
+    new_table->entries = calloc(new_table->capacity, sizeof(Symbol));
+
+    if (!new_table->entries) {
+        free(new_table);
+        return NULL;
+    }
+
+    return new_table;
+}
+
+static Symbol* symbol_table_slot(Symbol* entries, size_t capacity, const char* name, uint32_t hash) {
+    size_t mask = capacity - 1;
+    size_t position = hash & mask;
+
+    while (entries[position].name) {
+        if (entries[position].hash == hash && strcmp(entries[position].name, name) == 0) {
+            break;
+        }
+        position = (position + 1) & mask;
+    }
+
+    return &entries[position];
+}
+
+static bool symbol_table_grow(SymbolTable* table) {
+    size_t new_capacity = table->capacity * 2;
+    Symbol* new_entries = calloc(new_capacity, sizeof(Symbol));
+    if (!new_entries) { return false; }
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        Symbol* entry = &table->entries[i];
+        if (!entry->name) { continue; }
+
+        *symbol_table_slot(new_entries, new_capacity, entry->name, entry->hash) = *entry;
+    }
+
+    free(table->entries);
+    table->entries = new_entries;
+    table->capacity = new_capacity;
+
+    return true;
+}
+
+// Returns 1 when the name was added, 0 when it is already in the table and -1
+// when the table could not grow.
+int symbol_table_insert(SymbolTable* table, const char* name, int index) {
+    if ((table->length + 1) * 4 > table->capacity * 3) {
+        if (!symbol_table_grow(table)) { return -1; }
+    }
+
+    uint32_t hash = symbol_hash(name);
+    Symbol* entry = symbol_table_slot(table->entries, table->capacity, name, hash);
+    if (entry->name) { return 0; }
+
+    entry->name = name;
+    entry->hash = hash;
+    entry->index = index;
+    table->length++;
+
+    return 1;
+}
+
+int symbol_table_find(SymbolTable* table, const char* name) {
+    Symbol* entry = symbol_table_slot(table->entries, table->capacity, name, symbol_hash(name));
+
+    return entry->name ? entry->index : -1;
+}
+
+void free_symbol_table(SymbolTable* table) {
+    if (!table) { return; }
+
+    free(table->entries);
+    free(table);
+}
@@ -0,0 +1,31 @@
+#ifndef Q_SYMBOLS_H
+#define Q_SYMBOLS_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----- SYMBOL TABLE -----
+// Maps a function name to its index in the module. Open addressing keeps a
+// lookup to a hash and a short probe regardless of how many functions exist.
+typedef struct {
+    const char* name;
+    uint32_t hash;
+    int index;
+} Symbol;
+
+typedef struct {
+    Symbol* entries;
+    size_t capacity;
+    size_t length;
+} SymbolTable;
+
+uint32_t symbol_hash(const char* name);
+
+SymbolTable* symbol_table_init(size_t capacity);
+int symbol_table_insert(SymbolTable* table, const char* name, int index);
+int symbol_table_find(SymbolTable* table, const char* name);
+void free_symbol_table(SymbolTable* table);
+
+#endif
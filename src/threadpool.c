@@ -0,0 +1,162 @@
+#include "threadpool.h"
+
+#define THREAD_POOL_ARENA_SIZE (64 * 1024)
+
+// ----- THREAD POOL -----
+int thread_pool_default_size() {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return cores > 0 ? (int)cores : 1;
+}
+
+// Hands out indices in chunks so workers touch the shared counter rarely
+// while still balancing uneven task sizes.
+static void thread_pool_work(ThreadPool* pool, int worker) {
+    Arena* scratch = pool->arenas[worker];
+
+    while (true) {
+        size_t start = atomic_fetch_add(&pool->next_index, pool->chunk_size);
+        if (start >= pool->task_count) { break; }
+
+        size_t end = start + pool->chunk_size;
+        if (end > pool->task_count) { end = pool->task_count; }
+
+        for (size_t i = start; i < end; i++) {
+            pool->task(pool->context, i, scratch);
+            arena_reset(scratch);
+        }
+    }
+}
+
+static void* thread_pool_worker_main(void* arg) {
+    ThreadPoolWorker* worker = arg;
+    ThreadPool* pool = worker->pool;
+    unsigned long seen_generation = 0;
+
+    while (true) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->shutting_down && pool->generation == seen_generation) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->shutting_down) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen_generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        thread_pool_work(pool, worker->id);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->busy_workers--;
+        if (pool->busy_workers == 0) {
+            pthread_cond_signal(&pool->work_done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+ThreadPool* thread_pool_init(int thread_count) {
+    if (thread_count < 1) { thread_count = 1; }
+
+    ThreadPool* new_pool = calloc(1, sizeof(ThreadPool));
+    if (!new_pool) { return NULL; }
+
+    new_pool->threads = calloc(thread_count, sizeof(pthread_t));
+    new_pool->workers = calloc(thread_count, sizeof(ThreadPoolWorker));
+    new_pool->arenas = calloc(thread_count, sizeof(Arena*));
+
+    pthread_mutex_init(&new_pool->lock, NULL);
+    pthread_cond_init(&new_pool->work_ready, NULL);
+    pthread_cond_init(&new_pool->work_done, NULL);
+    atomic_init(&new_pool->next_index, 0);
+
+    // thread_count only counts workers that exist, so a failure part way
+    // through can be cleaned up by the normal free.
+    new_pool->thread_count = 0;
+    if (!new_pool->threads || !new_pool->workers || !new_pool->arenas) {
+        free_thread_pool(new_pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < thread_count; i++) {
+        new_pool->arenas[i] = arena_init(THREAD_POOL_ARENA_SIZE);
+        new_pool->workers[i].pool = new_pool;
+        new_pool->workers[i].id = i;
+
+        if (!new_pool->arenas[i]) {
+            free_thread_pool(new_pool);
+            return NULL;
+        }
+
+        // Worker 0 is whichever thread calls thread_pool_run.
+        if (i > 0 && pthread_create(&new_pool->threads[i], NULL, thread_pool_worker_main, &new_pool->workers[i]) != 0) {
+            free_arena(new_pool->arenas[i]);
+            free_thread_pool(new_pool);
+            return NULL;
+        }
+
+        new_pool->thread_count = i + 1;
+    }
+
+    return new_pool;
+}
+
+void thread_pool_run(ThreadPool* pool, size_t task_count, ThreadPoolTask task, void* context) {
+    if (task_count == 0) { return; }
+
+    pool->task = task;
+    pool->context = context;
+    pool->task_count = task_count;
+
+    size_t chunk_size = task_count / ((size_t)pool->thread_count * 8);
+    if (chunk_size < 1) { chunk_size = 1; }
+    if (chunk_size > 64) { chunk_size = 64; }
+    pool->chunk_size = chunk_size;
+    atomic_store(&pool->next_index, 0);
+
+    // Not worth waking anyone for a single task.
+    if (pool->thread_count == 1 || task_count == 1) {
+        thread_pool_work(pool, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->busy_workers = pool->thread_count - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    thread_pool_work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy_workers > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void free_thread_pool(ThreadPool* pool) {
+    if (!pool) { return; }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutting_down = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (int i = 0; i < pool->thread_count; i++) {
+        if (pool->arenas) { free_arena(pool->arenas[i]); }
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->arenas);
+    free(pool);
+}
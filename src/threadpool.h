@@ -0,0 +1,49 @@
+#ifndef Q_THREADPOOL_H
+#define Q_THREADPOOL_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "arena.h"
+
+// ----- THREAD POOL -----
+// Runs a batch of independent tasks, one per index, and returns once all of
+// them finished. The calling thread works as worker 0. Each worker owns a
+// scratch arena that is reset after every task it runs.
+typedef void (*ThreadPoolTask)(void* context, size_t index, Arena* scratch);
+
+struct ThreadPool;
+
+typedef struct {
+    struct ThreadPool* pool;
+    int id;
+} ThreadPoolWorker;
+
+typedef struct ThreadPool {
+    pthread_t* threads;
+    ThreadPoolWorker* workers;
+    Arena** arenas;
+    int thread_count;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    unsigned long generation;
+    int busy_workers;
+    bool shutting_down;
+
+    ThreadPoolTask task;
+    void* context;
+    size_t task_count;
+    size_t chunk_size;
+    atomic_size_t next_index;
+} ThreadPool;
+
+int thread_pool_default_size();
+ThreadPool* thread_pool_init(int thread_count);
+void thread_pool_run(ThreadPool* pool, size_t task_count, ThreadPoolTask task, void* context);
+void free_thread_pool(ThreadPool* pool);
+
+#endif